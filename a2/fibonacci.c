@@ -1,4 +1,11 @@
 #include "fibonacci.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SQR_THRESHOLD 32   // limbs below which squaring is schoolbook
+
+typedef unsigned long long LIMB;
+typedef unsigned __int128 DLIMB;
 
 /**
  * Compute F(n) iteratively.
@@ -82,3 +89,403 @@ int dptd_fibonacci(int *f, int n) {
     f[n] = fibNm1 + fibNm2;
     return f[n];
 }
+
+/**
+ * Compute F(n) with fast doubling, walking the bits of n from the top:
+ * (F(k), F(k+1)) -> (F(2k), F(2k+1)) and, for a set bit, one step more.
+ */
+unsigned long long fast_fibonacci(int n) {
+    if (n < 0 || n > FIB64_MAX) {
+        return 0;
+    }
+    unsigned long long a = 0, b = 1;  // F(k), F(k+1) with k = 0
+    for (int bit = 31 - __builtin_clz(n | 1); bit >= 0; bit--) {
+        unsigned long long c = a * (2 * b - a);  // F(2k)
+        unsigned long long d = a * a + b * b;    // F(2k+1)
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+#ifdef __SIZEOF_INT128__
+/**
+ * Same as fast_fibonacci() with 128-bit arithmetic.
+ */
+unsigned __int128 fast_fibonacci128(int n) {
+    if (n < 0 || n > FIB128_MAX) {
+        return 0;
+    }
+    unsigned __int128 a = 0, b = 1;
+    for (int bit = 31 - __builtin_clz(n | 1); bit >= 0; bit--) {
+        unsigned __int128 c = a * (2 * b - a);
+        unsigned __int128 d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+#endif
+
+/*
+ * Limb array helpers. Arrays are least significant limb first;
+ * "size" never counts high zero limbs after normalize().
+ */
+static int normalize(LIMB *a, int n) {
+    while (n > 0 && a[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+// r[0..rn) += a[0..an), an <= rn, returns the carry out of r
+static LIMB add_into(LIMB *r, int rn, LIMB *a, int an) {
+    LIMB carry = 0;
+    int i = 0;
+    for (; i < an; i++) {
+        LIMB s = r[i] + carry;
+        carry = (s < carry);
+        r[i] = s + a[i];
+        carry += (r[i] < s);
+    }
+    for (; carry && i < rn; i++) {
+        r[i]++;
+        carry = (r[i] == 0);
+    }
+    return carry;
+}
+
+// r[0..rn) -= a[0..an), an <= rn, returns the borrow out of r
+static LIMB sub_into(LIMB *r, int rn, LIMB *a, int an) {
+    LIMB borrow = 0;
+    int i = 0;
+    for (; i < an; i++) {
+        LIMB d = r[i] - borrow;
+        borrow = (d > r[i]);
+        borrow += (d < a[i]);
+        r[i] = d - a[i];
+    }
+    for (; borrow && i < rn; i++) {
+        borrow = (r[i] == 0);
+        r[i]--;
+    }
+    return borrow;
+}
+
+// r[0..2n) = a[0..n)^2, schoolbook: off-diagonal products doubled plus the squares
+static void sqr_basecase(LIMB *r, LIMB *a, int n) {
+    memset(r, 0, sizeof(LIMB) * 2 * n);
+    for (int i = 0; i < n; i++) {
+        LIMB carry = 0;
+        for (int j = i + 1; j < n; j++) {
+            DLIMB t = (DLIMB) a[i] * a[j] + r[i + j] + carry;
+            r[i + j] = (LIMB) t;
+            carry = (LIMB) (t >> 64);
+        }
+        r[i + n] = carry;
+    }
+    LIMB top = 0;
+    for (int i = 0; i < 2 * n; i++) {
+        LIMB v = r[i];
+        r[i] = (v << 1) | top;
+        top = v >> 63;
+    }
+    LIMB carry = 0;
+    for (int i = 0; i < n; i++) {
+        DLIMB t = (DLIMB) a[i] * a[i];
+        DLIMB lo = (DLIMB) r[2 * i] + (LIMB) t + carry;
+        r[2 * i] = (LIMB) lo;
+        DLIMB hi = (DLIMB) r[2 * i + 1] + (LIMB) (t >> 64) + (LIMB) (lo >> 64);
+        r[2 * i + 1] = (LIMB) hi;
+        carry = (LIMB) (hi >> 64);
+    }
+}
+
+/*
+ * r[0..2n) = a[0..n)^2 by Karatsuba: with a = a1*B^h + a0,
+ * a^2 = a1^2*B^2h + ((a0+a1)^2 - a0^2 - a1^2)*B^h + a0^2.
+ * scratch needs about 3n + 3*log2(n) limbs.
+ */
+static void sqr(LIMB *r, LIMB *a, int n, LIMB *scratch) {
+    if (n < SQR_THRESHOLD) {
+        sqr_basecase(r, a, n);
+        return;
+    }
+    int h = (n + 1) / 2, l = n - h;
+    LIMB *t = scratch;            // a0 + a1, h+1 limbs
+    LIMB *z1 = t + h + 1;         // (a0 + a1)^2, 2h+2 limbs
+    LIMB *next = z1 + 2 * h + 2;
+
+    sqr(r, a, h, next);                 // a0^2 in r[0..2h)
+    sqr(r + 2 * h, a + h, l, next);     // a1^2 in r[2h..2n)
+
+    memcpy(t, a, sizeof(LIMB) * h);
+    t[h] = add_into(t, h, a + h, l);
+    int tn = normalize(t, h + 1);
+    memset(z1, 0, sizeof(LIMB) * (2 * h + 2));
+    if (tn > 0)
+        sqr(z1, t, tn, next);
+    sub_into(z1, 2 * h + 2, r, 2 * h);
+    sub_into(z1, 2 * h + 2, r + 2 * h, 2 * l);
+    add_into(r + h, 2 * n - h, z1, normalize(z1, 2 * h + 2));
+}
+
+// r[0..n+1) = a[0..n) * m + add, m and add small
+static void mul_1(LIMB *r, LIMB *a, int n, LIMB m, LIMB add) {
+    LIMB carry = add;
+    for (int i = 0; i < n; i++) {
+        DLIMB t = (DLIMB) a[i] * m + carry;
+        r[i] = (LIMB) t;
+        carry = (LIMB) (t >> 64);
+    }
+    r[n] = carry;
+}
+
+// Copy limbs a[0..n) into a new BIGNUM r; returns 0 if memory runs out
+static int bignum_set(BIGNUM *r, LIMB *a, int n) {
+    r->limb = malloc(sizeof(LIMB) * (n > 0 ? n : 1));
+    if (r->limb == NULL) {
+        r->size = r->capacity = 0;
+        return 0;
+    }
+    memcpy(r->limb, a, sizeof(LIMB) * n);
+    r->size = n;
+    r->capacity = n > 0 ? n : 1;
+    return 1;
+}
+
+/**
+ * Fast doubling on limb arrays with the state (F(k), F(k-1)), two
+ * squarings per bit:
+ *   F(2k-1) = F(k)^2 + F(k-1)^2
+ *   F(2k+1) = 4*F(k)^2 - F(k-1)^2 + 2*(-1)^k
+ *   F(2k)   = F(2k+1) - F(2k-1)
+ * Sets r = F(n) and, if prev is not NULL, prev = F(n-1), for n >= 1.
+ * Returns 0 if memory runs out.
+ */
+static int fibonacci_big_pair(int n, BIGNUM *r, BIGNUM *prev) {
+    // F(n) < phi^n, log2(phi) < 0.6943
+    int cap = (int) (n * 0.6943 / 64) + 4;
+    LIMB *mem = malloc(sizeof(LIMB) * (cap * 10 + 256));
+    if (mem == NULL) {
+        return 0;
+    }
+    LIMB *fk = mem, *fk1 = fk + cap;                 // F(k), F(k-1)
+    LIMB *s1 = fk1 + cap, *s0 = s1 + 2 * cap;        // squares
+    LIMB *scratch = s0 + 2 * cap;
+    int fkn = 1, fk1n = 0;
+    fk[0] = 1;                                       // k = 1
+    int k_odd = 1;
+
+    int top = 30;
+    while (!((n >> top) & 1)) {
+        top--;
+    }
+    for (int bit = top - 1; bit >= 0; bit--) {
+        sqr(s1, fk, fkn, scratch);
+        int s1n = normalize(s1, 2 * fkn);
+        int s0n = 0;
+        if (fk1n > 0) {
+            sqr(s0, fk1, fk1n, scratch);
+            s0n = normalize(s0, 2 * fk1n);
+        }
+        // fk = F(2k+1) = 4*s1 - s0 +/- 2
+        mul_1(fk, s1, s1n, 4, k_odd ? 0 : 2);
+        int an = normalize(fk, s1n + 1);
+        sub_into(fk, an, s0, s0n);
+        if (k_odd) {
+            LIMB two = 2;
+            sub_into(fk, an, &two, 1);
+        }
+        an = normalize(fk, an);
+        // s1 = F(2k-1) = s1 + s0
+        LIMB c = add_into(s1, s1n, s0, s0n);
+        s1[s1n] = c;
+        int bn = normalize(s1, s1n + 1);
+        // fk1 = F(2k) = F(2k+1) - F(2k-1)
+        memcpy(fk1, fk, sizeof(LIMB) * an);
+        sub_into(fk1, an, s1, bn);
+        int cn = normalize(fk1, an);
+
+        if ((n >> bit) & 1) {
+            // (F(2k+1), F(2k)): fk already holds F(2k+1)
+            fkn = an;
+            fk1n = cn;
+            k_odd = 1;
+        } else {
+            // (F(2k), F(2k-1))
+            memcpy(fk, fk1, sizeof(LIMB) * cn);
+            fkn = cn;
+            memcpy(fk1, s1, sizeof(LIMB) * bn);
+            fk1n = bn;
+            k_odd = 0;
+        }
+    }
+
+    int ok = bignum_set(r, fk, fkn);
+    if (ok && prev != NULL) {
+        ok = bignum_set(prev, fk1, fk1n);
+        if (!ok)
+            bignum_clean(r);
+    }
+    free(mem);
+    return ok;
+}
+
+BIGNUM fast_fibonacci_big(int n) {
+    BIGNUM r = { 0, 0, NULL };
+    if (n > 0) {
+        fibonacci_big_pair(n, &r, NULL);
+    }
+    return r;
+}
+
+/**
+ * Repeatedly divide a copy by 10^19 and emit 19 digits per step.
+ */
+char *bignum_str(BIGNUM *a) {
+    int n = a->size;
+    // 64 bits < 20 decimal digits per limb
+    char *s = malloc(20 * (n > 0 ? n : 1) + 2);
+    LIMB *q = malloc(sizeof(LIMB) * (n > 0 ? n : 1));
+    if (s == NULL || q == NULL) {
+        free(s);
+        free(q);
+        return NULL;
+    }
+    if (n > 0) {
+        memcpy(q, a->limb, sizeof(LIMB) * n);
+    }
+    const LIMB base = 10000000000000000000ULL;  // 10^19
+    int len = 0;
+    while (n > 0) {
+        DLIMB rem = 0;
+        for (int i = n - 1; i >= 0; i--) {
+            DLIMB cur = (rem << 64) | q[i];
+            q[i] = (LIMB) (cur / base);
+            rem = cur % base;
+        }
+        n = normalize(q, n);
+        LIMB chunk = (LIMB) rem;
+        for (int d = 0; d < 19 && (n > 0 || chunk > 0); d++) {
+            s[len++] = (char) ('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    if (len == 0) {
+        s[len++] = '0';
+    }
+    for (int i = 0; i < len / 2; i++) {
+        char t = s[i];
+        s[i] = s[len - 1 - i];
+        s[len - 1 - i] = t;
+    }
+    s[len] = '\0';
+    free(q);
+    return s;
+}
+
+long bignum_bits(BIGNUM *a) {
+    if (a->size == 0) {
+        return 0;
+    }
+    return 64L * (a->size - 1) + (64 - __builtin_clzll(a->limb[a->size - 1]));
+}
+
+void bignum_clean(BIGNUM *a) {
+    free(a->limb);
+    a->limb = NULL;
+    a->size = 0;
+    a->capacity = 0;
+}
+
+/**
+ * Fill a range of Fibonacci numbers from F(a), F(a+1).
+ */
+int fibonacci_range(unsigned long long *f, int a, int b) {
+    if (f == NULL || a < 0 || b < a || b > FIB64_MAX) {
+        return -1;
+    }
+    f[0] = fast_fibonacci(a);
+    if (b > a) {
+        f[1] = fast_fibonacci(a + 1);
+    }
+    for (int i = 2; i <= b - a; i++) {
+        f[i] = f[i - 2] + f[i - 1];
+    }
+    return b - a + 1;
+}
+
+#ifdef __SIZEOF_INT128__
+int fibonacci_range128(unsigned __int128 *f, int a, int b) {
+    if (f == NULL || a < 0 || b < a || b > FIB128_MAX) {
+        return -1;
+    }
+    f[0] = fast_fibonacci128(a);
+    if (b > a) {
+        f[1] = fast_fibonacci128(a + 1);
+    }
+    for (int i = 2; i <= b - a; i++) {
+        f[i] = f[i - 2] + f[i - 1];
+    }
+    return b - a + 1;
+}
+#endif
+
+// r = x + y as a new BIGNUM; returns 0 if memory runs out
+static int bignum_sum(BIGNUM *r, BIGNUM *x, BIGNUM *y) {
+    if (x->size < y->size) {
+        BIGNUM *t = x;
+        x = y;
+        y = t;
+    }
+    r->limb = malloc(sizeof(LIMB) * (x->size + 1));
+    if (r->limb == NULL) {
+        r->size = r->capacity = 0;
+        return 0;
+    }
+    memcpy(r->limb, x->limb, sizeof(LIMB) * x->size);
+    r->limb[x->size] = add_into(r->limb, x->size, y->limb, y->size);
+    r->size = normalize(r->limb, x->size + 1);
+    r->capacity = x->size + 1;
+    return 1;
+}
+
+/**
+ * One fast doubling gives F(a+1) and F(a); the rest are one BIGNUM addition each.
+ */
+int fibonacci_range_big(BIGNUM *f, int a, int b) {
+    if (f == NULL || a < 0 || b < a) {
+        return -1;
+    }
+    int m = b - a + 1;
+    BIGNUM next = { 0, 0, NULL };       // F(a+1)
+    f[0] = next;
+    if (!fibonacci_big_pair(a + 1, &next, &f[0])) {
+        return -1;
+    }
+    if (m == 1) {
+        bignum_clean(&next);
+        return m;
+    }
+    f[1] = next;
+    for (int i = 2; i < m; i++) {
+        if (!bignum_sum(&f[i], &f[i - 2], &f[i - 1])) {
+            while (i > 0) {
+                bignum_clean(&f[--i]);
+            }
+            return -1;
+        }
+    }
+    return m;
+}
@@ -1,6 +1,19 @@
 #ifndef FIBONACCI_H
 #define FIBONACCI_H
 
+#define FIB64_MAX 93    // largest n with F(n) < 2^64
+#define FIB128_MAX 186  // largest n with F(n) < 2^128
+
+/*
+ * Arbitrary-precision natural number for fast_fibonacci_big():
+ * limb[0..size-1] holds the value in base 2^64, least significant limb first.
+ */
+typedef struct {
+    int size;
+    int capacity;
+    unsigned long long *limb;
+} BIGNUM;
+
 /**
  * Compute and return the nth Fibonacci number F(n) using an iterative algorithm. 
  * This uses a simple loop and tracks two consecutive Fibonacci numbers.
@@ -44,4 +57,90 @@ int dpbu_fibonacci(int *f, int n);
  */
 int dptd_fibonacci(int *f, int n);
 
+/**
+ * Compute and return F(n) in O(log n) steps with fast doubling:
+ * F(2k) = F(k) * (2*F(k+1) - F(k)) and F(2k+1) = F(k)^2 + F(k+1)^2.
+ *
+ * @param n - The n for F(n), 0 <= n <= FIB64_MAX
+ * @return F(n), or 0 if n is out of range
+ */
+unsigned long long fast_fibonacci(int n);
+
+#ifdef __SIZEOF_INT128__
+/**
+ * 128-bit version of fast_fibonacci() for 0 <= n <= FIB128_MAX.
+ *
+ * @param n - The n for F(n)
+ * @return F(n), or 0 if n is out of range
+ */
+unsigned __int128 fast_fibonacci128(int n);
+#endif
+
+/**
+ * Compute F(n) for any n >= 0 with fast doubling over BIGNUM. Each step
+ * takes two squarings, with Karatsuba squaring for large operands:
+ * F(2k-1) = F(k)^2 + F(k-1)^2, F(2k+1) = 4*F(k)^2 - F(k-1)^2 + 2*(-1)^k.
+ * Release the result with bignum_clean().
+ *
+ * @param n - The n for F(n)
+ * @return F(n) as a BIGNUM (size 0 if memory runs out)
+ */
+BIGNUM fast_fibonacci_big(int n);
+
+/**
+ * Convert a BIGNUM to a decimal string allocated with malloc().
+ * Quadratic in the length, meant for display of moderate values.
+ *
+ * @param a - the number
+ * @return the digit string, or NULL if memory runs out
+ */
+char *bignum_str(BIGNUM *a);
+
+/**
+ * Number of bits of a BIGNUM value (0 for zero).
+ */
+long bignum_bits(BIGNUM *a);
+
+/**
+ * Free the limbs of a BIGNUM and reset it to zero.
+ */
+void bignum_clean(BIGNUM *a);
+
+/**
+ * Fill f[0..b-a] with F(a), F(a+1), ..., F(b): fast doubling for F(a)
+ * and F(a+1), then one addition per element.
+ *
+ * @param f - caller buffer of b-a+1 elements
+ * @param a - first index, a >= 0
+ * @param b - last index, a <= b <= FIB64_MAX; use fibonacci_range128() or
+ *            fibonacci_range_big() for larger indexes
+ * @return the number of elements written, or -1 if the range is invalid
+ */
+int fibonacci_range(unsigned long long *f, int a, int b);
+
+#ifdef __SIZEOF_INT128__
+/**
+ * 128-bit version of fibonacci_range() for a <= b <= FIB128_MAX.
+ *
+ * @param f - caller buffer of b-a+1 elements
+ * @param a - first index, a >= 0
+ * @param b - last index, a <= b <= FIB128_MAX
+ * @return the number of elements written, or -1 if the range is invalid
+ */
+int fibonacci_range128(unsigned __int128 *f, int a, int b);
+#endif
+
+/**
+ * BIGNUM version of fibonacci_range() for any 0 <= a <= b: one fast
+ * doubling for F(a) and F(a+1), then one BIGNUM addition per element.
+ * Release each element with bignum_clean().
+ *
+ * @param f - caller array of b-a+1 BIGNUMs, overwritten
+ * @param a - first index, a >= 0
+ * @param b - last index, a <= b
+ * @return the number of elements written, or -1 if the range is invalid
+ *         or memory runs out (nothing is left allocated then)
+ */
+int fibonacci_range_big(BIGNUM *f, int a, int b);
+
 #endif
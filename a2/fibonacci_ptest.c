@@ -10,6 +10,7 @@ Version: 2025-01-14
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include "fibonacci.h"
 
@@ -85,6 +86,57 @@ void test_dptd_fibonacci()
 	printf("\n");
 }
 
+void test_fast_fibonacci()
+{
+	printf("------------------\n");
+	printf("Test: fast_fibonacci, fast_fibonacci_big, fibonacci_range\n\n");
+	int count = sizeof tests / sizeof(int);
+	for (int i = 0; i < count; i++)
+		printf("fast_fibonacci(%d): %llu\n", tests[i], fast_fibonacci(tests[i]));
+	printf("fast_fibonacci(%d): %llu\n", FIB64_MAX, fast_fibonacci(FIB64_MAX));
+
+	BIGNUM f = fast_fibonacci_big(200);
+	char *s = bignum_str(&f);
+	printf("fast_fibonacci_big(%d): %s\n", 200, s);
+	free(s);
+	bignum_clean(&f);
+
+	unsigned long long r[5];
+	int m = fibonacci_range(r, 50, 54);
+	printf("fibonacci_range(50 54):");
+	for (int i = 0; i < m; i++)
+		printf(" %llu", r[i]);
+	printf("\n");
+
+	int same;
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 r128[7];
+	m = fibonacci_range128(r128, FIB128_MAX - 6, FIB128_MAX);
+	same = m == 7;
+	for (int i = 0; i < m; i++)
+		same &= r128[i] == fast_fibonacci128(FIB128_MAX - 6 + i);
+	printf("fibonacci_range128(%d %d): %d elements, %s\n", FIB128_MAX - 6, FIB128_MAX,
+		m, same ? "match fast_fibonacci128" : "MISMATCH");
+#endif
+
+	BIGNUM rb[4];
+	m = fibonacci_range_big(rb, 1000, 1003);
+	same = m == 4;
+	for (int i = 0; i < m; i++) {
+		f = fast_fibonacci_big(1000 + i);
+		char *x = bignum_str(&rb[i]), *y = bignum_str(&f);
+		same &= strcmp(x, y) == 0;
+		free(x);
+		free(y);
+		bignum_clean(&f);
+	}
+	printf("fibonacci_range_big(1000 1003): %d elements, %s\n", m,
+		same ? "match fast_fibonacci_big" : "MISMATCH");
+	for (int i = 0; i < m; i++)
+		bignum_clean(&rb[i]);
+	printf("\n");
+}
+
 void test_time_fibonacci()
 {
 	printf("------------------\n");
@@ -144,6 +196,24 @@ void test_time_fibonacci()
 	printf("time_span(dptd_fibonacci(%d))/time_span(iterative_fibonacci(%d)):%0.1f\n", n, n, (time_span4/time_span1)*(m1/m4));
 	printf("time_span(recursive_fibonacci(%d))/time_span(dptd_fibonacci(%d)):%0.1f\n", n, n, (time_span2/time_span4)*(m4/m2));
 
+	volatile unsigned long long sink = 0;
+	int m5 = 500000;
+	t1=clock();
+	for (int i=0; i< m5; i++) {
+	  sink += fast_fibonacci(n);
+	}
+	t2=clock();
+	double time_span5 = (double) t2-t1;
+	printf("time_span(fast_fibonacci(%d) for %d times):%0.1f (ms)\n", n, m5, time_span5);
+	printf("time_span(iterative_fibonacci(%d))/time_span(fast_fibonacci(%d)):%0.1f\n", n, n, (time_span1/time_span5)*(m5/m1));
+
+	int big = 10000000;
+	t1=clock();
+	BIGNUM fb = fast_fibonacci_big(big);
+	t2=clock();
+	printf("time_span(fast_fibonacci_big(%d)):%0.1f (s), %ld bits\n", big, (double) (t2-t1)/CLOCKS_PER_SEC, bignum_bits(&fb));
+	bignum_clean(&fb);
+
 
 	printf("\n");
 }
@@ -157,6 +227,7 @@ int main(int argc, char *args[])
 		test_recursive_fibonacci();
 		test_dpbu_fibonacci();
 		test_dptd_fibonacci();
+		test_fast_fibonacci();
 	}
 	else
 	{
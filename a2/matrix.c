@@ -1,5 +1,25 @@
 #include "matrix.h"
 #include <math.h>   // for sqrt()
+#include <stdlib.h> // for malloc(), free()
+#include <string.h> // for memset()
+#include <pthread.h>
+#include <unistd.h> // for sysconf()
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATRIX_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * Blocking parameters of matrix_gemm().
+ * A micro-tile of c is MR-by-NR; a packed block of a is MC-by-KC (L2 sized)
+ * and a packed panel of b is KC-by-NR (L1 sized).
+ */
+#define MR 6
+#define NR 16
+#define MC 120
+#define KC 256
+#define NC 3072
 
 float norm(float *v, int n) {
     float sum = 0.0f;
@@ -29,10 +49,17 @@ void matrix_multiply_vector(float *m, float *v, float *vout, int n) {
     }
 }
 
-void matrix_multiply_matrix(float *m1, float *m2, float *m3, int n) {
+/*
+ * Rows [r0, r1) of the n-by-n product m3 = m1 * m2.
+ */
+static void multiply_rows(float *m1, float *m2, float *m3, int n, int r0, int r1) {
+    if (n >= GEMM_MIN_N) {
+        matrix_gemm(m1 + r0 * n, m2, m3 + r0 * n, r1 - r0, n, n, n, n, n);
+        return;
+    }
     // Each of m1, m2, m3 is n-by-n in row-major order.
     // m3[i*n + j] = sum of (m1[i*n + k] * m2[k*n + j]) for k=0..n-1
-    for (int i = 0; i < n; i++) {
+    for (int i = r0; i < r1; i++) {
         for (int j = 0; j < n; j++) {
             float sum = 0.0f;
             for (int k = 0; k < n; k++) {
@@ -42,3 +69,420 @@ void matrix_multiply_matrix(float *m1, float *m2, float *m3, int n) {
         }
     }
 }
+
+void matrix_multiply_matrix(float *m1, float *m2, float *m3, int n) {
+    multiply_rows(m1, m2, m3, n, 0, n);
+}
+
+/*
+ * Copy the mc-by-kc block of a starting at a into ap as MR-row panels,
+ * each stored column by column (ap[p*MR + i]), zero-padding the last panel.
+ */
+static void pack_a(float *a, int lda, int mc, int kc, float *ap) {
+    for (int ir = 0; ir < mc; ir += MR) {
+        int mr = (mc - ir < MR) ? mc - ir : MR;
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < mr; i++) {
+                ap[p * MR + i] = a[(ir + i) * lda + p];
+            }
+            for (int i = mr; i < MR; i++) {
+                ap[p * MR + i] = 0.0f;
+            }
+        }
+        ap += MR * kc;
+    }
+}
+
+/*
+ * Copy the kc-by-nc block of b starting at b into bp as NR-column panels,
+ * each stored row by row (bp[p*NR + j]), zero-padding the last panel.
+ */
+static void pack_b(float *b, int ldb, int kc, int nc, float *bp) {
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = (nc - jr < NR) ? nc - jr : NR;
+        for (int p = 0; p < kc; p++) {
+            for (int j = 0; j < nr; j++) {
+                bp[p * NR + j] = b[p * ldb + jr + j];
+            }
+            for (int j = nr; j < NR; j++) {
+                bp[p * NR + j] = 0.0f;
+            }
+        }
+        bp += NR * kc;
+    }
+}
+
+/*
+ * Store (first != 0) or accumulate an MR-by-NR tile into the mr-by-nr
+ * top-left corner of c.
+ */
+static void write_tile(float *tile, float *c, int ldc, int mr, int nr, int first) {
+    for (int i = 0; i < mr; i++) {
+        for (int j = 0; j < nr; j++) {
+            if (first)
+                c[i * ldc + j] = tile[i * NR + j];
+            else
+                c[i * ldc + j] += tile[i * NR + j];
+        }
+    }
+}
+
+/*
+ * Portable micro-kernel: tile = ap * bp over kc, then written into c.
+ */
+static void kernel_portable(int kc, float *ap, float *bp, float *c, int ldc,
+                            int mr, int nr, int first) {
+    float tile[MR * NR] = { 0 };
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < MR; i++) {
+            float aip = ap[p * MR + i];
+            for (int j = 0; j < NR; j++) {
+                tile[i * NR + j] += aip * bp[p * NR + j];
+            }
+        }
+    }
+    write_tile(tile, c, ldc, mr, nr, first);
+}
+
+#ifdef MATRIX_X86
+/*
+ * AVX2/FMA micro-kernel: the 6-by-16 tile lives in 12 ymm registers.
+ */
+__attribute__((target("avx2,fma")))
+static void kernel_avx2(int kc, float *ap, float *bp, float *c, int ldc,
+                        int mr, int nr, int first) {
+    __m256 acc[MR][2];
+    for (int i = 0; i < MR; i++) {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+    for (int p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_loadu_ps(bp + p * NR);
+        __m256 b1 = _mm256_loadu_ps(bp + p * NR + 8);
+        for (int i = 0; i < MR; i++) {
+            __m256 aip = _mm256_broadcast_ss(ap + p * MR + i);
+            acc[i][0] = _mm256_fmadd_ps(aip, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(aip, b1, acc[i][1]);
+        }
+    }
+    if (mr == MR && nr == NR) {
+        for (int i = 0; i < MR; i++) {
+            float *ci = c + i * ldc;
+            if (!first) {
+                acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(ci));
+                acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(ci + 8));
+            }
+            _mm256_storeu_ps(ci, acc[i][0]);
+            _mm256_storeu_ps(ci + 8, acc[i][1]);
+        }
+    } else {
+        float tile[MR * NR];
+        for (int i = 0; i < MR; i++) {
+            _mm256_storeu_ps(tile + i * NR, acc[i][0]);
+            _mm256_storeu_ps(tile + i * NR + 8, acc[i][1]);
+        }
+        write_tile(tile, c, ldc, mr, nr, first);
+    }
+}
+#endif
+
+typedef void (*gemm_kernel)(int, float *, float *, float *, int, int, int, int);
+
+static gemm_kernel gemm_selected = NULL;
+static pthread_once_t gemm_select_once = PTHREAD_ONCE_INIT;
+
+static void select_kernel_once(void) {
+    gemm_selected = kernel_portable;
+#ifdef MATRIX_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        gemm_selected = kernel_avx2;
+#endif
+}
+
+/*
+ * Select the micro-kernel once, based on the features of the running CPU.
+ * The pool workers call matrix_gemm() concurrently, so the choice is made
+ * under pthread_once.
+ */
+static gemm_kernel select_kernel(void) {
+    pthread_once(&gemm_select_once, select_kernel_once);
+    return gemm_selected;
+}
+
+/*
+ * c = a * b with the plain triple loop, needing no buffers; the fallback of
+ * matrix_gemm() when the packing buffers cannot be allocated.
+ */
+static void gemm_unpacked(float *a, float *b, float *c, int m, int n, int k,
+                          int lda, int ldb, int ldc) {
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            float sum = 0.0f;
+            for (int p = 0; p < k; p++) {
+                sum += a[i * lda + p] * b[p * ldb + j];
+            }
+            c[i * ldc + j] = sum;
+        }
+    }
+}
+
+void matrix_gemm(float *a, float *b, float *c, int m, int n, int k,
+                 int lda, int ldb, int ldc) {
+    if (m <= 0 || n <= 0)
+        return;
+    if (k <= 0) {
+        for (int i = 0; i < m; i++)
+            memset(c + i * ldc, 0, n * sizeof(float));
+        return;
+    }
+
+    gemm_kernel kernel = select_kernel();
+    int kcmax = (k < KC) ? k : KC;
+    int ncmax = (n < NC) ? n : NC;
+    float *ap = malloc(sizeof(float) * (MC + MR) * kcmax);
+    float *bp = malloc(sizeof(float) * (ncmax + NR) * kcmax);
+    if (ap == NULL || bp == NULL) {
+        free(ap);
+        free(bp);
+        gemm_unpacked(a, b, c, m, n, k, lda, ldb, ldc);
+        return;
+    }
+
+    // c is written by the first k-block and accumulated by the others.
+    for (int jc = 0; jc < n; jc += NC) {
+        int nc = (n - jc < NC) ? n - jc : NC;
+        for (int pc = 0; pc < k; pc += KC) {
+            int kc = (k - pc < KC) ? k - pc : KC;
+            pack_b(b + pc * ldb + jc, ldb, kc, nc, bp);
+            for (int ic = 0; ic < m; ic += MC) {
+                int mc = (m - ic < MC) ? m - ic : MC;
+                pack_a(a + ic * lda + pc, lda, mc, kc, ap);
+                for (int jr = 0; jr < nc; jr += NR) {
+                    int nr = (nc - jr < NR) ? nc - jr : NR;
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        int mr = (mc - ir < MR) ? mc - ir : MR;
+                        kernel(kc, ap + ir * kc, bp + jr * kc,
+                               c + (ic + ir) * ldc + jc + jr, ldc, mr, nr, pc == 0);
+                    }
+                }
+            }
+        }
+    }
+
+    free(ap);
+    free(bp);
+}
+
+/*
+ * Persistent worker pool for the parallel kernels.
+ * The calling thread acts as worker 0; workers 1..size-1 sleep on start
+ * until a new generation of work is posted, run it, and report on done.
+ */
+typedef void (*pool_task)(void *arg, int id, int count);
+
+typedef struct {
+    pthread_t *threads;
+    int size;                // number of workers including the caller
+    int requested;           // workers asked for when started, >= size
+    int generation;          // incremented for every posted task
+    int pending;             // workers still running the current task
+    int quit;
+    pool_task task;
+    void *arg;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+} POOL;
+
+typedef struct {
+    POOL *pool;
+    int id;
+} WORKER;
+
+static POOL pool = { NULL, 0, 0, 0, 0, 0, NULL, NULL,
+                     PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                     PTHREAD_COND_INITIALIZER };
+static pthread_mutex_t pool_run_lock = PTHREAD_MUTEX_INITIALIZER;
+static int pool_threads = 0;   // requested thread count, 0 = online CPUs
+static WORKER *pool_workers = NULL;
+
+static void *pool_worker(void *p) {
+    WORKER *w = p;
+    POOL *pl = w->pool;
+    int seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pl->lock);
+        while (pl->generation == seen && !pl->quit)
+            pthread_cond_wait(&pl->start, &pl->lock);
+        if (pl->quit) {
+            pthread_mutex_unlock(&pl->lock);
+            return NULL;
+        }
+        seen = pl->generation;
+        pool_task task = pl->task;
+        void *arg = pl->arg;
+        int count = pl->size;
+        pthread_mutex_unlock(&pl->lock);
+
+        task(arg, w->id, count);
+
+        pthread_mutex_lock(&pl->lock);
+        if (--pl->pending == 0)
+            pthread_cond_signal(&pl->done);
+        pthread_mutex_unlock(&pl->lock);
+    }
+}
+
+static void pool_stop(void) {
+    if (pool.threads == NULL)
+        return;
+    pthread_mutex_lock(&pool.lock);
+    pool.quit = 1;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+    for (int i = 1; i < pool.size; i++)
+        pthread_join(pool.threads[i], NULL);
+    free(pool.threads);
+    free(pool_workers);
+    pool.threads = NULL;
+    pool_workers = NULL;
+    pool.size = 0;
+    pool.requested = 0;
+    pool.generation = 0;
+    pool.quit = 0;
+}
+
+static void pool_start(int size) {
+    pool.threads = malloc(sizeof(pthread_t) * size);
+    pool_workers = malloc(sizeof(WORKER) * size);
+    if (pool.threads == NULL || pool_workers == NULL) {
+        free(pool.threads);
+        free(pool_workers);
+        pool.threads = NULL;
+        pool_workers = NULL;
+        return;
+    }
+    // If a thread cannot be created, the pool runs with the workers started
+    // so far; requested keeps the count it was started for.
+    pool.size = 1;
+    pool.requested = size;
+    for (int i = 1; i < size; i++) {
+        pool_workers[i].pool = &pool;
+        pool_workers[i].id = i;
+        if (pthread_create(&pool.threads[i], NULL, pool_worker, &pool_workers[i]) != 0)
+            break;
+        pool.size++;
+    }
+}
+
+/*
+ * Thread count to use; the caller holds pool_run_lock.
+ */
+static int threads_locked(void) {
+    if (pool_threads > 0)
+        return pool_threads;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cpus > 0) ? (int) cpus : 1;
+}
+
+/*
+ * Run task(arg, id, count) on every worker of the pool and wait for all.
+ */
+static void pool_run(pool_task task, void *arg) {
+    pthread_mutex_lock(&pool_run_lock);
+    int size = threads_locked();
+    if (pool.threads != NULL && pool.requested != size)
+        pool_stop();
+    if (pool.threads == NULL && size > 1)
+        pool_start(size);
+    if (pool.threads == NULL || pool.size <= 1) {
+        task(arg, 0, 1);
+        pthread_mutex_unlock(&pool_run_lock);
+        return;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.task = task;
+    pool.arg = arg;
+    pool.pending = pool.size - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+
+    task(arg, 0, pool.size);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.pending > 0)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool_run_lock);
+}
+
+void matrix_set_threads(int nthreads) {
+    pthread_mutex_lock(&pool_run_lock);
+    pool_threads = (nthreads > 0) ? nthreads : 0;
+    pthread_mutex_unlock(&pool_run_lock);
+}
+
+int matrix_get_threads(void) {
+    pthread_mutex_lock(&pool_run_lock);
+    int size = threads_locked();
+    pthread_mutex_unlock(&pool_run_lock);
+    return size;
+}
+
+void matrix_free_threads(void) {
+    pthread_mutex_lock(&pool_run_lock);
+    pool_stop();
+    pthread_mutex_unlock(&pool_run_lock);
+}
+
+typedef struct {
+    float *m1;
+    float *m2;
+    float *m3;
+    int n;
+} MULTIPLY_ARGS;
+
+/*
+ * Split [0, n) into count contiguous ranges whose length is a multiple
+ * of step (except the last) and return range id in *r0, *r1.
+ */
+static void split_rows(int n, int step, int id, int count, int *r0, int *r1) {
+    int rows = (n + count - 1) / count;
+    rows = (rows + step - 1) / step * step;
+    *r0 = id * rows < n ? id * rows : n;
+    *r1 = *r0 + rows < n ? *r0 + rows : n;
+}
+
+static void vector_task(void *p, int id, int count) {
+    MULTIPLY_ARGS *args = p;
+    int n = args->n, r0, r1;
+    split_rows(n, 1, id, count, &r0, &r1);
+    for (int i = r0; i < r1; i++) {
+        float sum = 0.0f;
+        for (int j = 0; j < n; j++) {
+            sum += args->m1[i * n + j] * args->m2[j];
+        }
+        args->m3[i] = sum;
+    }
+}
+
+static void matrix_task(void *p, int id, int count) {
+    MULTIPLY_ARGS *args = p;
+    int r0, r1;
+    split_rows(args->n, MR, id, count, &r0, &r1);
+    if (r0 < r1)
+        multiply_rows(args->m1, args->m2, args->m3, args->n, r0, r1);
+}
+
+void matrix_multiply_vector_parallel(float *m, float *v, float *vout, int n) {
+    MULTIPLY_ARGS args = { m, v, vout, n };
+    pool_run(vector_task, &args);
+}
+
+void matrix_multiply_matrix_parallel(float *m1, float *m2, float *m3, int n) {
+    MULTIPLY_ARGS args = { m1, m2, m3, n };
+    pool_run(matrix_task, &args);
+}
@@ -1,6 +1,8 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#define GEMM_MIN_N 64   // square size from which matrix_multiply_matrix() uses matrix_gemm()
+
 /**
  * Compute and return the norm of vector v, i.e., 
  * the square root of the sum of the squares of its elements.
@@ -44,4 +46,73 @@ void matrix_multiply_vector(float *m, float *v, float *vout, int n);
  */
 void matrix_multiply_matrix(float *m1, float *m2, float *m3, int n);
 
+/**
+ * Compute the general matrix product c = a * b, where a is m-by-k,
+ * b is k-by-n and c is m-by-n, all in row-major order with leading
+ * dimensions (row strides) lda, ldb and ldc.
+ *
+ * Panels of a and b are packed into contiguous buffers and multiplied
+ * tile by tile with an AVX2/FMA micro-kernel when the CPU supports it
+ * (checked at runtime), otherwise with a portable kernel. If the packing
+ * buffers cannot be allocated, c is computed with an unpacked loop.
+ * matrix_multiply_matrix() uses this for n >= GEMM_MIN_N.
+ *
+ * @param a   - pointer to the first element of the m-by-k matrix
+ * @param b   - pointer to the first element of the k-by-n matrix
+ * @param c   - pointer to the first element of the m-by-n output matrix
+ * @param m   - number of rows of a and c
+ * @param n   - number of columns of b and c
+ * @param k   - number of columns of a and rows of b
+ * @param lda - row stride of a (lda >= k)
+ * @param ldb - row stride of b (ldb >= n)
+ * @param ldc - row stride of c (ldc >= n)
+ */
+void matrix_gemm(float *a, float *b, float *c, int m, int n, int k,
+                 int lda, int ldb, int ldc);
+
+/**
+ * Set the number of threads used by the parallel matrix kernels.
+ * The workers are created on the first parallel call and kept in a pool
+ * for later calls; changing the count rebuilds the pool.
+ *
+ * @param nthreads - thread count cap, or 0 for the number of online CPUs
+ */
+void matrix_set_threads(int nthreads);
+
+/**
+ * Return the number of threads the parallel matrix kernels will use.
+ */
+int matrix_get_threads(void);
+
+/**
+ * Stop and join the worker threads of the pool.
+ * The next parallel call creates the pool again.
+ */
+void matrix_free_threads(void);
+
+/**
+ * Parallel version of matrix_multiply_vector(). The rows of vout are split
+ * into one contiguous range per thread, so the result is identical to
+ * the serial function for any thread count.
+ *
+ * @param m    - pointer to the first element of the n-by-n matrix
+ * @param v    - pointer to the vector
+ * @param vout - pointer to the output vector
+ * @param n    - the dimension of the matrix and vector
+ */
+void matrix_multiply_vector_parallel(float *m, float *v, float *vout, int n);
+
+/**
+ * Parallel version of matrix_multiply_matrix(). The rows of m3 are split
+ * into one contiguous range per thread (a multiple of the micro-tile
+ * height), so the result is identical to the serial function for any
+ * thread count.
+ *
+ * @param m1 - pointer to the first element of the first matrix
+ * @param m2 - pointer to the first element of the second matrix
+ * @param m3 - pointer to the output matrix
+ * @param n  - the row/column dimension for the square matrices
+ */
+void matrix_multiply_matrix_parallel(float *m1, float *m2, float *m3, int n);
+
 #endif
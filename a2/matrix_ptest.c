@@ -9,6 +9,8 @@
  */
 
 #include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
 #include "matrix.h"
 
 char *fm ="%.1f";  //format string for float number
@@ -90,10 +92,160 @@ void test_matrix_multiply_matrix() {
 	printf("\n");
 }
 
-int main() {
-	test_norm();
-	test_dot_product();
-	test_matrix_multiply_vector();
-	test_matrix_multiply_matrix();
+void test_matrix_gemm() {
+	printf("------------------\n");
+	printf("Test: matrix_gemm\n\n");
+	// a is 2-by-3 stored with row stride 4, b is 3-by-2 stored with row stride 3
+	float a[8] = { 1, 2, 3, -1, 4, 5, 6, -1 };
+	float b[9] = { 1, 0, -1, 0, 1, -1, 1, 1, -1 };
+	float c[4] = { 0 };
+	matrix_gemm(a, b, c, 2, 2, 3, 4, 3, 2);
+	printf("matrix_gemm(%s %s %s)\n", "a", "b", "c");
+	printf("c:\n");
+	for (int i = 0; i < 2; i++) {
+		for (int j = 0; j < 2; j++) {
+			printf(fm, c[i * 2 + j]);
+			printf(" ");
+		}
+		printf("\n");
+	}
+	printf("\n");
+}
+
+void test_matrix_parallel() {
+	printf("------------------\n");
+	printf("Test: matrix_multiply_vector_parallel, matrix_multiply_matrix_parallel\n\n");
+	int n = 3;
+	float v[] = { 1, 1, 1 };
+	float m1[9] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+	float m2[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	float v1[3], m3[9];
+	matrix_set_threads(2);
+	matrix_multiply_vector_parallel(m2, v, v1, n);
+	printf("matrix_multiply_vector_parallel(%s %s %s)\n", "m2", "v", "v1");
+	display_vector("v1", v1, n);
+	matrix_multiply_matrix_parallel(m1, m2, m3, n);
+	printf("matrix_multiply_matrix_parallel(%s %s %s)\n", "m1", "m2", "m3");
+	display_matrix("m3", m3, n);
+	matrix_free_threads();
+	matrix_set_threads(0);
+	printf("\n");
+}
+
+// the textbook i-j-k loop, used as the baseline for timing
+void naive_multiply(float *m1, float *m2, float *m3, int n) {
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			float sum = 0.0f;
+			for (int k = 0; k < n; k++) {
+				sum += m1[i * n + k] * m2[k * n + j];
+			}
+			m3[i * n + j] = sum;
+		}
+	}
+}
+
+void time_test_matrix(int max_n) {
+	printf("------------------\n");
+	printf("Test: matrix multiply runtime, GFLOP/s\n\n");
+	for (int n = 256; n <= max_n; n *= 2) {
+		float *m1 = malloc(sizeof(float) * n * n);
+		float *m2 = malloc(sizeof(float) * n * n);
+		float *m3 = malloc(sizeof(float) * n * n);
+		float *m4 = malloc(sizeof(float) * n * n);
+		for (int i = 0; i < n * n; i++) {
+			m1[i] = (float) rand() / RAND_MAX - 0.5f;
+			m2[i] = (float) rand() / RAND_MAX - 0.5f;
+		}
+		double flops = 2.0 * n * n * n;
+
+		clock_t t1 = clock();
+		naive_multiply(m1, m2, m3, n);
+		clock_t t2 = clock();
+		double s1 = (double) (t2 - t1) / CLOCKS_PER_SEC;
+
+		t1 = clock();
+		matrix_multiply_matrix(m1, m2, m4, n);
+		t2 = clock();
+		double s2 = (double) (t2 - t1) / CLOCKS_PER_SEC;
+
+		float maxdiff = 0;
+		for (int i = 0; i < n * n; i++) {
+			float d = m3[i] > m4[i] ? m3[i] - m4[i] : m4[i] - m3[i];
+			if (d > maxdiff)
+				maxdiff = d;
+		}
+		printf("n=%d naive:%0.2f GFLOP/s gemm:%0.2f GFLOP/s speedup:%0.1f max_diff:%g\n",
+				n, flops / s1 / 1e9, flops / s2 / 1e9, s1 / s2, maxdiff);
+		free(m1);
+		free(m2);
+		free(m3);
+		free(m4);
+	}
+	printf("\n");
+}
+
+// wall-clock seconds, clock() adds up the time of all threads
+double wall_time() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void time_test_parallel(int n) {
+	printf("------------------\n");
+	printf("Test: parallel matrix multiply scaling, n=%d\n\n", n);
+	float *m1 = malloc(sizeof(float) * n * n);
+	float *m2 = malloc(sizeof(float) * n * n);
+	float *m3 = malloc(sizeof(float) * n * n);
+	float *v = malloc(sizeof(float) * n);
+	float *vout = malloc(sizeof(float) * n);
+	for (int i = 0; i < n * n; i++) {
+		m1[i] = (float) rand() / RAND_MAX - 0.5f;
+		m2[i] = (float) rand() / RAND_MAX - 0.5f;
+	}
+	for (int i = 0; i < n; i++)
+		v[i] = (float) rand() / RAND_MAX - 0.5f;
+
+	matrix_set_threads(0);
+	int max_threads = matrix_get_threads();
+	double base = 0;
+	for (int t = 1; t <= max_threads; t++) {
+		matrix_set_threads(t);
+		matrix_multiply_matrix_parallel(m1, m2, m3, GEMM_MIN_N); // warm up the pool
+		double t1 = wall_time();
+		matrix_multiply_matrix_parallel(m1, m2, m3, n);
+		double t2 = wall_time();
+		for (int r = 0; r < 100; r++)
+			matrix_multiply_vector_parallel(m1, v, vout, n);
+		double t3 = wall_time();
+		if (t == 1)
+			base = t2 - t1;
+		printf("threads=%d matrix:%0.2f GFLOP/s speedup:%0.2f vector(x100):%0.1f ms\n",
+				t, 2.0 * n * n * n / (t2 - t1) / 1e9, base / (t2 - t1),
+				(t3 - t2) * 1000);
+	}
+	matrix_free_threads();
+	matrix_set_threads(0);
+	free(m1);
+	free(m2);
+	free(m3);
+	free(v);
+	free(vout);
+	printf("\n");
+}
+
+int main(int argc, char *args[]) {
+	if (argc <= 1) {
+		test_norm();
+		test_dot_product();
+		test_matrix_multiply_vector();
+		test_matrix_multiply_matrix();
+		test_matrix_gemm();
+		test_matrix_parallel();
+	} else {
+		time_test_matrix(atoi(args[1]));
+		time_test_parallel(atoi(args[1]));
+	}
 	return 0;
 }
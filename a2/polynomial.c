@@ -1,4 +1,23 @@
 #include "polynomial.h"
+#include <stdlib.h>  // for malloc(), free()
+#include <math.h>    // for fabs(), pow()
+#include <complex.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POLYNOMIAL_X86
+#include <immintrin.h>
+#endif
+
+#define LANES 8          // points per block of the portable kernels
+#define ESTRIN_STACK 64  // Estrin terms kept on the stack before using malloc()
+#define NEWTON_STACK 64  // derivative coefficients kept on the stack by newton()
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define ROOTS_MAX_ITER 500
+#define ROOTS_TOL 1e-14
 
 /* Simple absolute value function to avoid <math.h>. */
 static float my_abs(float x) {
@@ -18,6 +37,178 @@ float horner(float *p, int n, float x) {
     return result;
 }
 
+/*
+ * Horner's rule on LANES points at once, same operation order as horner().
+ */
+static void horner_block(float *p, int n, float *x, float *y) {
+    float r[LANES];
+    for (int l = 0; l < LANES; l++)
+        r[l] = p[0];
+    for (int i = 1; i < n; i++) {
+        for (int l = 0; l < LANES; l++)
+            r[l] = r[l] * x[l] + p[i];
+    }
+    for (int l = 0; l < LANES; l++)
+        y[l] = r[l];
+}
+
+/*
+ * Estrin's scheme on LANES points at once; t is scratch of
+ * (n+1)/2 * LANES floats. With c[j] = p[n-1-j] the coefficient of x^j:
+ *   t[j] = c[2j] + c[2j+1]*x, then t[j] = t[2j] + t[2j+1]*x^2, ...
+ */
+static void estrin_block(float *p, int n, float *x, float *y, float *t) {
+    float xx[LANES];
+    int m = 0;
+    for (int j = n - 1; j >= 0; j -= 2, m++) {
+        for (int l = 0; l < LANES; l++)
+            t[m * LANES + l] = (j > 0) ? p[j] + p[j - 1] * x[l] : p[j];
+    }
+    for (int l = 0; l < LANES; l++)
+        xx[l] = x[l] * x[l];
+    while (m > 1) {
+        int k = 0;
+        for (int j = 0; j < m; j += 2, k++) {
+            for (int l = 0; l < LANES; l++)
+                t[k * LANES + l] = (j + 1 < m)
+                        ? t[j * LANES + l] + t[(j + 1) * LANES + l] * xx[l]
+                        : t[j * LANES + l];
+        }
+        m = k;
+        for (int l = 0; l < LANES; l++)
+            xx[l] = xx[l] * xx[l];
+    }
+    for (int l = 0; l < LANES; l++)
+        y[l] = t[l];
+}
+
+/*
+ * Portable batch kernel; returns the number of points done (a multiple of LANES).
+ */
+static int batch_portable(float *p, int n, float *x, float *y, int count,
+                          EVALSCHEME scheme, float *t) {
+    int i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        if (scheme == POLY_ESTRIN)
+            estrin_block(p, n, x + i, y + i, t);
+        else
+            horner_block(p, n, x + i, y + i);
+    }
+    return i;
+}
+
+#ifdef POLYNOMIAL_X86
+/*
+ * AVX batch kernel, 16 points per step in two independent registers;
+ * separate multiply and add keep the rounding of horner().
+ */
+__attribute__((target("avx")))
+static int batch_avx(float *p, int n, float *x, float *y, int count,
+                     EVALSCHEME scheme, float *t) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 x0 = _mm256_loadu_ps(x + i);
+        __m256 x1 = _mm256_loadu_ps(x + i + 8);
+        __m256 r0, r1;
+        if (scheme == POLY_ESTRIN) {
+            int m = 0;
+            for (int j = n - 1; j >= 0; j -= 2, m++) {
+                __m256 c = _mm256_set1_ps(p[j]);
+                if (j > 0) {
+                    __m256 d = _mm256_set1_ps(p[j - 1]);
+                    _mm256_storeu_ps(t + 16 * m, _mm256_add_ps(c, _mm256_mul_ps(d, x0)));
+                    _mm256_storeu_ps(t + 16 * m + 8, _mm256_add_ps(c, _mm256_mul_ps(d, x1)));
+                } else {
+                    _mm256_storeu_ps(t + 16 * m, c);
+                    _mm256_storeu_ps(t + 16 * m + 8, c);
+                }
+            }
+            __m256 xx0 = _mm256_mul_ps(x0, x0);
+            __m256 xx1 = _mm256_mul_ps(x1, x1);
+            while (m > 1) {
+                int k = 0;
+                for (int j = 0; j < m; j += 2, k++) {
+                    __m256 a0 = _mm256_loadu_ps(t + 16 * j);
+                    __m256 a1 = _mm256_loadu_ps(t + 16 * j + 8);
+                    if (j + 1 < m) {
+                        a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(t + 16 * (j + 1)), xx0));
+                        a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(t + 16 * (j + 1) + 8), xx1));
+                    }
+                    _mm256_storeu_ps(t + 16 * k, a0);
+                    _mm256_storeu_ps(t + 16 * k + 8, a1);
+                }
+                m = k;
+                xx0 = _mm256_mul_ps(xx0, xx0);
+                xx1 = _mm256_mul_ps(xx1, xx1);
+            }
+            r0 = _mm256_loadu_ps(t);
+            r1 = _mm256_loadu_ps(t + 8);
+        } else {
+            r0 = r1 = _mm256_set1_ps(p[0]);
+            for (int j = 1; j < n; j++) {
+                __m256 c = _mm256_set1_ps(p[j]);
+                r0 = _mm256_add_ps(_mm256_mul_ps(r0, x0), c);
+                r1 = _mm256_add_ps(_mm256_mul_ps(r1, x1), c);
+            }
+        }
+        _mm256_storeu_ps(y + i, r0);
+        _mm256_storeu_ps(y + i + 8, r1);
+    }
+    return i;
+}
+#endif
+
+typedef int (*batch_kernel)(float *, int, float *, float *, int, EVALSCHEME, float *);
+
+static batch_kernel select_batch_kernel(void) {
+    static batch_kernel kernel = NULL;
+    if (kernel == NULL) {
+        kernel = batch_portable;
+#ifdef POLYNOMIAL_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx"))
+            kernel = batch_avx;
+#endif
+    }
+    return kernel;
+}
+
+/**
+ * Batch evaluation: SIMD kernel for whole blocks, then horner()/Estrin
+ * on a padded block for the remaining points.
+ */
+void horner_batch(float *p, int n, float *x, float *y, int count, EVALSCHEME scheme) {
+    if (n <= 0 || count <= 0)
+        return;
+
+    // Estrin scratch: (n+1)/2 terms of 16 lanes
+    float stack[ESTRIN_STACK * 16];
+    float *t = stack;
+    int terms = (n + 1) / 2;
+    if (scheme == POLY_ESTRIN && terms > ESTRIN_STACK) {
+        t = malloc(sizeof(float) * terms * 16);
+        if (t == NULL)
+            scheme = POLY_HORNER;
+    }
+
+    int done = select_batch_kernel()(p, n, x, y, count, scheme, t);
+    done += batch_portable(p, n, x + done, y + done, count - done, scheme, t);
+    if (done < count) {
+        float xr[LANES] = { 0 }, yr[LANES];
+        for (int i = done; i < count; i++)
+            xr[i - done] = x[i];
+        if (scheme == POLY_ESTRIN)
+            estrin_block(p, n, xr, yr, t);
+        else
+            horner_block(p, n, xr, yr);
+        for (int i = done; i < count; i++)
+            y[i] = yr[i - done];
+    }
+
+    if (t != stack)
+        free(t);
+}
+
 /**
  * Derivative of polynomial p(x):
  * p'(x) = (n-1)*p[0]*x^{n-2} + (n-2)*p[1]*x^{n-3} + ... + 1*p[n-2].
@@ -39,7 +230,13 @@ float newton(float *p, int n, float x0) {
     int max_iter = 100;
 
     // Compute derivative polynomial once (n-1 coefficients)
-    float d[64];  // Assume n <= 64 or adjust as needed
+    float stack[NEWTON_STACK];
+    float *d = stack;
+    if (n - 1 > NEWTON_STACK) {
+        d = malloc(sizeof(float) * (n - 1));
+        if (d == NULL)
+            return x0;
+    }
     derivative(p, d, n);
 
     float xk = x0;
@@ -49,20 +246,195 @@ float newton(float *p, int n, float x0) {
 
         // If derivative is 0 or extremely close to 0, we can't update
         if (my_abs(fpx) < tol) {
-            return xk;
+            break;
         }
 
         float x_next = xk - fx / fpx;
 
         // Check convergence
         if (my_abs(x_next - xk) < tol) {
-            return x_next;
+            xk = x_next;
+            break;
         }
 
         xk = x_next;
     }
 
-    // If we get here, it didn't converge within 100 iterations
-    // Return whatever we have as best guess
+    // If it didn't converge within 100 iterations,
+    // xk is whatever we have as best guess
+    if (d != stack)
+        free(d);
     return xk;
 }
+
+/**
+ * Aberth-Ehrlich iteration. Work layout for degree d:
+ * a[d+1] monic coefficients, da[d] derivative, z[d] complex estimates,
+ * done[d] convergence flags.
+ */
+int polynomial_roots(float *p, int n, ROOT *roots, double *work) {
+    int lead = 0;
+    while (lead < n && p[lead] == 0.0f)
+        lead++;
+    int d = n - 1 - lead;   // degree after dropping leading zeros
+    if (d <= 0)
+        return 0;
+
+    double *scratch = work;
+    if (scratch == NULL) {
+        scratch = malloc(sizeof(double) * ROOTS_WORK_SIZE(n));
+        if (scratch == NULL)
+            return -1;
+    }
+    double *a = scratch;
+    double *da = a + d + 1;
+    double complex *z = (double complex *) (da + d);
+    double *done = (double *) (z + d);
+
+    // Zero roots are exact: strip trailing zero coefficients.
+    int zeros = 0;
+    while (zeros < d && p[n - 1 - zeros] == 0.0f) {
+        roots[d - 1 - zeros].re = 0.0;
+        roots[d - 1 - zeros].im = 0.0;
+        zeros++;
+    }
+    int m = d - zeros;      // degree of the remaining polynomial
+    for (int i = 0; i <= m; i++)
+        a[i] = (double) p[lead + i] / p[lead];
+    for (int i = 0; i < m; i++)
+        da[i] = (m - i) * a[i];
+
+    // Start on a circle of radius |a[m]|^(1/m), the geometric mean of
+    // the root magnitudes, rotated off the real axis.
+    double r = pow(fabs(a[m]), 1.0 / (m > 0 ? m : 1));
+    if (r == 0.0 || !isfinite(r))
+        r = 1.0;
+    for (int k = 0; k < m; k++) {
+        z[k] = r * cexp(I * (2.0 * M_PI * k / m + 0.4));
+        done[k] = 0.0;
+    }
+
+    int converged = (m == 0);
+    for (int iter = 0; iter < ROOTS_MAX_ITER && !converged; iter++) {
+        converged = 1;
+        for (int k = 0; k < m; k++) {
+            if (done[k] != 0.0)
+                continue;
+            double complex f = a[0], fp = da[0];
+            for (int i = 1; i <= m; i++)
+                f = f * z[k] + a[i];
+            for (int i = 1; i < m; i++)
+                fp = fp * z[k] + da[i];
+            if (f == 0.0) {
+                done[k] = 1.0;
+                continue;
+            }
+            double complex w = f / fp;
+            double complex s = 0.0;
+            for (int j = 0; j < m; j++) {
+                if (j != k)
+                    s += 1.0 / (z[k] - z[j]);
+            }
+            double complex corr = w / (1.0 - w * s);
+            if (!isfinite(creal(corr)) || !isfinite(cimag(corr))) {
+                converged = 0;
+                continue;
+            }
+            z[k] -= corr;
+            if (cabs(corr) <= ROOTS_TOL * cabs(z[k]))
+                done[k] = 1.0;
+            else
+                converged = 0;
+        }
+    }
+
+    for (int k = 0; k < m; k++) {
+        roots[k].re = creal(z[k]);
+        roots[k].im = cimag(z[k]);
+    }
+    if (scratch != work)
+        free(scratch);
+    return converged ? d : -1;
+}
+
+typedef struct {
+    float *p;
+    int n;
+    int first;
+    int last;
+    ROOT *roots;
+    int *status;
+    double *work;
+    int failed;
+} ROOTS_JOB;
+
+static void *roots_worker(void *arg) {
+    ROOTS_JOB *job = arg;
+    for (int i = job->first; i < job->last; i++) {
+        int r = polynomial_roots(job->p + (long) i * job->n, job->n,
+                                 job->roots + (long) i * (job->n - 1), job->work);
+        if (job->status != NULL)
+            job->status[i] = r;
+        if (r < 0)
+            job->failed++;
+    }
+    return NULL;
+}
+
+int polynomial_roots_batch(float *p, int n, int count, ROOT *roots, int *status,
+                           double *work, int nthreads) {
+    if (count <= 0 || n <= 0)
+        return 0;
+    if (nthreads < 1)
+        nthreads = 1;
+    if (nthreads > count)
+        nthreads = count;
+
+    double *scratch = work;
+    if (scratch == NULL) {
+        scratch = malloc(sizeof(double) * ROOTS_WORK_SIZE(n) * nthreads);
+        if (scratch == NULL)
+            return count;
+    }
+    ROOTS_JOB *jobs = malloc(sizeof(ROOTS_JOB) * nthreads);
+    pthread_t *threads = malloc(sizeof(pthread_t) * nthreads);
+    if (jobs == NULL || threads == NULL) {
+        free(jobs);
+        free(threads);
+        if (scratch != work)
+            free(scratch);
+        return count;
+    }
+
+    int chunk = (count + nthreads - 1) / nthreads;
+    for (int t = 0; t < nthreads; t++) {
+        jobs[t].p = p;
+        jobs[t].n = n;
+        jobs[t].first = t * chunk < count ? t * chunk : count;
+        jobs[t].last = (t + 1) * chunk < count ? (t + 1) * chunk : count;
+        jobs[t].roots = roots;
+        jobs[t].status = status;
+        jobs[t].work = scratch + (long) t * ROOTS_WORK_SIZE(n);
+        jobs[t].failed = 0;
+    }
+    // Thread 0 is the caller; if a thread can't be started, its
+    // polynomials are solved by the caller as well.
+    int started[nthreads];
+    for (int t = 1; t < nthreads; t++)
+        started[t] = pthread_create(&threads[t], NULL, roots_worker, &jobs[t]) == 0;
+    roots_worker(&jobs[0]);
+    int failed = jobs[0].failed;
+    for (int t = 1; t < nthreads; t++) {
+        if (started[t])
+            pthread_join(threads[t], NULL);
+        else
+            roots_worker(&jobs[t]);
+        failed += jobs[t].failed;
+    }
+
+    free(jobs);
+    free(threads);
+    if (scratch != work)
+        free(scratch);
+    return failed;
+}
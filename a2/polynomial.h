@@ -1,6 +1,28 @@
 #ifndef POLYNOMIAL_H
 #define POLYNOMIAL_H
 
+/*
+ * Evaluation scheme of horner_batch().
+ * POLY_HORNER - Horner's rule, the same operations as horner().
+ * POLY_ESTRIN - Estrin's scheme, evaluates coefficient pairs and combines
+ *               them with x^2, x^4, ..., so the dependency chain is
+ *               about 2*log2(n) operations instead of 2*(n-1).
+ */
+typedef enum { POLY_HORNER = 0, POLY_ESTRIN = 1 } EVALSCHEME;
+
+/*
+ * A complex root re + im*i.
+ */
+typedef struct {
+    double re;
+    double im;
+} ROOT;
+
+/*
+ * Number of doubles of scratch polynomial_roots() needs for n coefficients.
+ */
+#define ROOTS_WORK_SIZE(n) (5 * (n) + 1)
+
 /**
  * Compute and return the value of the (n-1)-th degree polynomial
  * p(x) = p[0]*x^{n-1} + p[1]*x^{n-2} + ... + p[n-2]*x + p[n-1]
@@ -13,6 +35,27 @@
  */
 float horner(float *p, int n, float x);
 
+/**
+ * Evaluate the (n-1)-th degree polynomial p at count points,
+ * y[i] = p(x[i]) for i = 0, ..., count-1, with 8 lanes per AVX register
+ * and two registers (16 points) per step when the CPU supports AVX
+ * (checked at runtime), otherwise with a portable 8-point loop.
+ *
+ * POLY_HORNER results are bit-identical to horner() (as long as the
+ * compiler does not fuse horner()'s multiply-add into an FMA).
+ * POLY_ESTRIN results differ from horner() by at most
+ * 4*(n-1) ulp of |p[0]|*|x|^{n-1} + ... + |p[n-1]|, the sum of the
+ * standard error bounds of both schemes.
+ *
+ * @param p      Pointer to array of polynomial coefficients
+ * @param n      Number of coefficients (the polynomial is degree n-1)
+ * @param x      Array of count evaluation points
+ * @param y      Output array of count values
+ * @param count  Number of points
+ * @param scheme POLY_HORNER or POLY_ESTRIN
+ */
+void horner_batch(float *p, int n, float *x, float *y, int count, EVALSCHEME scheme);
+
 /**
  * Compute the derivative coefficients of an (n-1)-th degree polynomial
  * p(x) = p[0]*x^{n-1} + p[1]*x^{n-2} + ... + p[n-2]*x + p[n-1].
@@ -34,6 +77,7 @@ void derivative(float *p, float *d, int n);
  * Newton's iteration: x_{k+1} = x_k - p(x_k)/p'(x_k).
  *
  * If p'(x_k) == 0 at any step, or if it fails to converge, return the latest x.
+ * The derivative is kept on the stack for n <= 65 and in malloc() memory above.
  *
  * @param p   Pointer to coefficient array of polynomial p(x)
  * @param n   Number of coefficients (polynomial is degree n-1)
@@ -42,4 +86,38 @@ void derivative(float *p, float *d, int n);
  */
 float newton(float *p, int n, float x0);
 
+/**
+ * Find all complex roots of p(x) at once with the Aberth-Ehrlich method
+ * in double precision. Leading zero coefficients are dropped, zero roots
+ * (trailing zero coefficients) are deflated exactly, and roots that have
+ * converged are frozen while the others keep iterating.
+ * At most 500 iterations, relative tolerance 1e-14.
+ *
+ * @param p     Pointer to coefficient array of polynomial p(x)
+ * @param n     Number of coefficients (polynomial is degree n-1)
+ * @param roots Output array of at least n-1 roots
+ * @param work  Scratch of ROOTS_WORK_SIZE(n) doubles, or NULL to use malloc()
+ * @return      Number of roots written (the actual degree), or -1 if the
+ *              iteration did not converge (roots hold the latest estimates)
+ */
+int polynomial_roots(float *p, int n, ROOT *roots, double *work);
+
+/**
+ * Solve count independent polynomials of n coefficients each with
+ * polynomial_roots(), splitting the batch over nthreads threads.
+ * Polynomial i is p[i*n .. i*n+n-1] and its roots go to
+ * roots[i*(n-1) .. i*(n-1)+n-2].
+ *
+ * @param p        Array of count*n coefficients
+ * @param n        Number of coefficients per polynomial
+ * @param count    Number of polynomials
+ * @param roots    Output array of count*(n-1) roots
+ * @param status   Optional output array of count return values of polynomial_roots()
+ * @param work     Scratch of nthreads*ROOTS_WORK_SIZE(n) doubles, or NULL
+ * @param nthreads Number of threads (1 solves in the calling thread)
+ * @return         Number of polynomials that did not converge
+ */
+int polynomial_roots_batch(float *p, int n, int count, ROOT *roots, int *status,
+                           double *work, int nthreads);
+
 #endif
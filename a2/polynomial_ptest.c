@@ -74,10 +74,86 @@ void test_newton()
 	printf("\n");
 }
 
+void test_horner_batch()
+{
+	printf("------------------\n");
+	printf("Test: horner_batch\n\n");
+	int n = sizeof(p) / sizeof(float);
+	int count = 37;
+	float xs[37], yh[37], ye[37];
+	for (int i = 0; i < count; i++)
+		xs[i] = -3.0f + i / 6.0f;
+	horner_batch(p, n, xs, yh, count, POLY_HORNER);
+	horner_batch(p, n, xs, ye, count, POLY_ESTRIN);
+
+	int same = 0, within = 0;
+	for (int i = 0; i < count; i++)
+	{
+		float h = horner(p, n, xs[i]);
+		float a = 0, ax = xs[i] < 0 ? -xs[i] : xs[i];
+		for (int j = 0; j < n; j++)
+			a = a * ax + (p[j] < 0 ? -p[j] : p[j]);
+		float d = ye[i] - h;
+		if (yh[i] == h)
+			same++;
+		if ((d < 0 ? -d : d) <= 4 * (n - 1) * a * 1.1920929e-7f)
+			within++;
+	}
+	for (int i = 0; i < count; i += 12)
+		printf("horner_batch(p %.2f): %.2f %.2f\n", xs[i], yh[i], ye[i]);
+	printf("horner equal to horner(): %d/%d\n", same, count);
+	printf("estrin within bound: %d/%d\n", within, count);
+	printf("\n");
+}
+
+void test_polynomial_roots()
+{
+	printf("------------------\n");
+	printf("Test: polynomial_roots\n\n");
+	int n = sizeof(p) / sizeof(float);
+	ROOT roots[3];
+	double work[ROOTS_WORK_SIZE(4)];
+	int r = polynomial_roots(p, n, roots, work);
+	printf("polynomial_roots(p): %d\n", r);
+	for (int i = 0; i < r; i++)
+		printf("root: %.4f%+.4fi\n", roots[i].re, roots[i].im);
+
+	// (x-1)(x-2)(x-3), x^3 - 4x and a degree-80 x^80 - 1 in one batch
+	float q[3 * 81] = { 0 };
+	float q1[] = { 1, -6, 11, -6 }, q2[] = { 1, 0, -4, 0 };
+	for (int i = 0; i < 4; i++) {
+		q[77 + i] = q1[i];
+		q[81 + 77 + i] = q2[i];
+	}
+	q[162] = 1;
+	q[242] = -1;
+	ROOT qr[3 * 80];
+	int status[3];
+	int failed = polynomial_roots_batch(q, 81, 3, qr, status, NULL, 2);
+	printf("polynomial_roots_batch(): %d failed\n", failed);
+	for (int i = 0; i < 2; i++) {
+		printf("roots(%d):", status[i]);
+		for (int j = 0; j < status[i]; j++)
+			printf(" %.4f%+.4fi", qr[i * 80 + j].re, qr[i * 80 + j].im);
+		printf("\n");
+	}
+	double maxerr = 0;
+	for (int j = 0; j < status[2]; j++) {
+		double m = qr[160 + j].re * qr[160 + j].re + qr[160 + j].im * qr[160 + j].im;
+		if ((m > 1 ? m - 1 : 1 - m) > maxerr)
+			maxerr = m > 1 ? m - 1 : 1 - m;
+	}
+	printf("roots(%d) of x^80-1, max ||z|^2-1|: %s\n", status[2],
+			maxerr < 1e-9 ? "< 1e-9" : "too large");
+	printf("\n");
+}
+
 int main()
 {
 	test_horner();
 	test_derivative();
 	test_newton();
+	test_horner_batch();
+	test_polynomial_roots();
 	return 0;
 }
@@ -1,6 +1,52 @@
 #include "mystring.h"
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
-int str_words(char *s) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MYSTRING_X86
+#include <immintrin.h>
+#endif
+
+static atomic_int simd_level = -1;   // kernel level, -1 until first use
+static int simd_max = 0;             // highest supported level, set once
+static pthread_once_t simd_once = PTHREAD_ONCE_INIT;
+
+static int simd_supported(void) {
+#ifdef MYSTRING_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return 2;
+    if (__builtin_cpu_supports("sse2"))
+        return 1;
+#endif
+    return 0;
+}
+
+static void init_compact_table(void);
+
+/*
+ * Detect the CPU and fill the lookup tables, once for all threads.
+ */
+static void simd_init(void) {
+#ifdef MYSTRING_X86
+    init_compact_table();
+#endif
+    simd_max = simd_supported();
+}
+
+int str_simd(int level) {
+    pthread_once(&simd_once, simd_init);
+    if (level >= 0) {
+        atomic_store(&simd_level, (level < simd_max) ? level : simd_max);
+    } else {
+        int unset = -1;
+        atomic_compare_exchange_strong(&simd_level, &unset, simd_max);
+    }
+    return atomic_load(&simd_level);
+}
+
+static int str_words_scalar(char *s) {
     int count = 0, in_word = 0;
     while (*s) {
         if ((*s >= 'A' && *s <= 'Z') || (*s >= 'a' && *s <= 'z')) {
@@ -16,7 +62,7 @@ int str_words(char *s) {
     return count;
 }
 
-int str_lower(char *s) {
+static int str_lower_scalar(char *s) {
     int count = 0;
     while (*s) {
         if (*s >= 'A' && *s <= 'Z') {
@@ -30,7 +76,7 @@ int str_lower(char *s) {
 
 
 
-void str_trim(char *s) {
+static void str_trim_scalar(char *s) {
     char *read = s, *write = s;
     while (*read == ' ') read++; 
 
@@ -50,3 +96,263 @@ void str_trim(char *s) {
     if (write > s && *(write - 1) == ' ') write--; 
     *write = '\0';
 }
+
+#ifdef MYSTRING_X86
+/*
+ * Masks of 64 bytes, bit i for byte i: letters (c | 0x20 in 'a'..'z'),
+ * word delimiters (' ', '\t', ',', '.') and spaces.
+ */
+typedef struct {
+    unsigned long long letter, delim, space;
+} CHARMASKS;
+
+static inline CHARMASKS classify_sse2(const char *p) {
+    CHARMASKS m = { 0, 0, 0 };
+    for (int k = 0; k < 4; k++) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 16 * k));
+        __m128i t = _mm_add_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8(128 - 'a'));
+        __m128i letter = _mm_cmplt_epi8(t, _mm_set1_epi8(-128 + 26));
+        __m128i space = _mm_cmpeq_epi8(c, _mm_set1_epi8(' '));
+        __m128i delim = _mm_or_si128(_mm_or_si128(space, _mm_cmpeq_epi8(c, _mm_set1_epi8('\t'))),
+                _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(',')), _mm_cmpeq_epi8(c, _mm_set1_epi8('.'))));
+        m.letter |= (unsigned long long)(unsigned)_mm_movemask_epi8(letter) << (16 * k);
+        m.delim |= (unsigned long long)(unsigned)_mm_movemask_epi8(delim) << (16 * k);
+        m.space |= (unsigned long long)(unsigned)_mm_movemask_epi8(space) << (16 * k);
+    }
+    return m;
+}
+
+__attribute__((target("avx2")))
+static inline CHARMASKS classify_avx2(const char *p) {
+    CHARMASKS m = { 0, 0, 0 };
+    for (int k = 0; k < 2; k++) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(p + 32 * k));
+        __m256i t = _mm256_add_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)),
+                _mm256_set1_epi8(128 - 'a'));
+        __m256i letter = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), t);
+        __m256i space = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(' '));
+        __m256i delim = _mm256_or_si256(
+                _mm256_or_si256(space, _mm256_cmpeq_epi8(c, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(',')),
+                        _mm256_cmpeq_epi8(c, _mm256_set1_epi8('.'))));
+        m.letter |= (unsigned long long)(unsigned)_mm256_movemask_epi8(letter) << (32 * k);
+        m.delim |= (unsigned long long)(unsigned)_mm256_movemask_epi8(delim) << (32 * k);
+        m.space |= (unsigned long long)(unsigned)_mm256_movemask_epi8(space) << (32 * k);
+    }
+    return m;
+}
+
+/*
+ * Word starts of one 64-byte block. Other characters keep the state, so
+ * byte i is "in a word" (f) if the last letter or delimiter at or before
+ * it is a letter. Adding the letters to the non-delimiter mask carries
+ * from the first letter of every non-delimiter run to its end; in_word
+ * enters as the carry, like a letter just before the block.
+ */
+static inline int count_starts(CHARMASKS m, int *in_word) {
+    unsigned long long prop = ~m.delim;
+    unsigned long long cin = (unsigned long long)*in_word;
+    unsigned long long f = (((m.letter + prop + cin) ^ prop) | m.letter) & prop;
+    unsigned long long starts = m.letter & ~((f << 1) | cin);
+    *in_word = (int)(f >> 63);
+    return __builtin_popcountll(starts);
+}
+
+static int str_words_sse2(char *s, int n) {
+    int count = 0, in_word = 0;
+    char block[64];
+    for (int i = 0; i < n; i += 64) {
+        const char *p = s + i;
+        if (n - i < 64) {   // zero-padded tail: NUL bytes keep the state
+            memset(block, 0, 64);
+            memcpy(block, p, n - i);
+            p = block;
+        }
+        count += count_starts(classify_sse2(p), &in_word);
+    }
+    return count;
+}
+
+__attribute__((target("avx2,popcnt")))
+static int str_words_avx2(char *s, int n) {
+    int count = 0, in_word = 0;
+    char block[64];
+    for (int i = 0; i < n; i += 64) {
+        const char *p = s + i;
+        if (n - i < 64) {
+            memset(block, 0, 64);
+            memcpy(block, p, n - i);
+            p = block;
+        }
+        count += count_starts(classify_avx2(p), &in_word);
+    }
+    return count;
+}
+
+/*
+ * Lowercase 'A'..'Z' by adding 0x20 under a range mask and count them.
+ */
+static int str_lower_sse2(char *s, int n) {
+    int count = 0, i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i c = _mm_loadu_si128((__m128i *)(s + i));
+        __m128i t = _mm_add_epi8(c, _mm_set1_epi8(128 - 'A'));
+        __m128i upper = _mm_cmplt_epi8(t, _mm_set1_epi8(-128 + 26));
+        int mask = _mm_movemask_epi8(upper);
+        if (mask != 0) {
+            _mm_storeu_si128((__m128i *)(s + i),
+                    _mm_add_epi8(c, _mm_and_si128(upper, _mm_set1_epi8(0x20))));
+            count += __builtin_popcount(mask);
+        }
+    }
+    return count + str_lower_scalar(s + i);
+}
+
+__attribute__((target("avx2,popcnt")))
+static int str_lower_avx2(char *s, int n) {
+    int count = 0, i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i c = _mm256_loadu_si256((__m256i *)(s + i));
+        __m256i t = _mm256_add_epi8(c, _mm256_set1_epi8(128 - 'A'));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), t);
+        unsigned mask = _mm256_movemask_epi8(upper);
+        if (mask != 0) {
+            _mm256_storeu_si256((__m256i *)(s + i),
+                    _mm256_add_epi8(c, _mm256_and_si256(upper, _mm256_set1_epi8(0x20))));
+            count += __builtin_popcount(mask);
+        }
+    }
+    return count + str_lower_sse2(s + i, n - i);
+}
+
+static unsigned char compact_table[256][8];   // pshufb indices of the kept bytes
+
+static void init_compact_table(void) {
+    for (int k = 0; k < 256; k++) {
+        int n = 0;
+        for (int b = 0; b < 8; b++) {
+            if (k & (1 << b))
+                compact_table[k][n++] = b;
+        }
+        while (n < 8)
+            compact_table[k][n++] = 0x80;
+    }
+}
+
+/*
+ * Copy the bytes of a 64-byte block whose bit is set in keep, in 8-byte
+ * groups: whole groups with one 8-byte move, others bit by bit, or with
+ * pshufb in the AVX2 version. Every group is loaded before its 8-byte
+ * store, and the store ends before the next group since write <= read.
+ */
+static inline char *compact_bits(char *write, const char *read, unsigned long long keep) {
+    for (int j = 0; j < 64; j += 8) {
+        unsigned k = (keep >> j) & 0xFF;
+        if (k == 0xFF) {
+            unsigned long long group;
+            memcpy(&group, read + j, 8);
+            memcpy(write, &group, 8);
+            write += 8;
+        } else {
+            while (k != 0) {
+                *write++ = read[j + __builtin_ctz(k)];
+                k &= k - 1;
+            }
+        }
+    }
+    return write;
+}
+
+__attribute__((target("avx2,popcnt")))
+static inline char *compact_pshufb(char *write, const char *read, unsigned long long keep) {
+    for (int j = 0; j < 64; j += 8) {
+        unsigned k = (keep >> j) & 0xFF;
+        __m128i group = _mm_loadl_epi64((const __m128i *)(read + j));
+        __m128i idx = _mm_loadl_epi64((const __m128i *)compact_table[k]);
+        _mm_storel_epi64((__m128i *)write, _mm_shuffle_epi8(group, idx));
+        write += __builtin_popcount(k);
+    }
+    return write;
+}
+
+/*
+ * Trim with 64-byte blocks: a space is dropped if the byte before it is a
+ * space (the last byte written, for the first byte of a block), then the
+ * kept bytes are compacted. Leading spaces and the tail use the byte loop.
+ */
+#define TRIM_BLOCKS(classify, compact)                                         \
+    char *read = s, *write = s, *end = s + n;                                  \
+    while (read < end && *read == ' ')                                         \
+        read++;                                                                \
+    unsigned long long space = 0;   /* the last byte written is a space */     \
+    while (end - read >= 64) {                                                 \
+        CHARMASKS m = classify(read);                                          \
+        unsigned long long keep = ~(m.space & ((m.space << 1) | space));       \
+        write = compact(write, read, keep);                                    \
+        read += 64;                                                            \
+        space = m.space >> 63;                                                 \
+    }                                                                          \
+    for (; read < end; read++) {                                               \
+        if (*read == ' ') {                                                    \
+            if (!space) {                                                      \
+                *write++ = ' ';                                                \
+                space = 1;                                                     \
+            }                                                                  \
+        } else {                                                               \
+            *write++ = *read;                                                  \
+            space = 0;                                                         \
+        }                                                                      \
+    }                                                                          \
+    if (write > s && *(write - 1) == ' ') write--;                             \
+    *write = '\0';
+
+static void str_trim_sse2(char *s, int n) {
+    TRIM_BLOCKS(classify_sse2, compact_bits)
+}
+
+__attribute__((target("avx2,popcnt")))
+static void str_trim_avx2(char *s, int n) {
+    TRIM_BLOCKS(classify_avx2, compact_pshufb)
+}
+#endif
+
+/*
+ * The vector kernels take the length from strlen() and give the same
+ * results as the byte loops.
+ */
+int str_words(char *s) {
+#ifdef MYSTRING_X86
+    int level = str_simd(-1);
+    if (level >= 2)
+        return str_words_avx2(s, strlen(s));
+    if (level == 1)
+        return str_words_sse2(s, strlen(s));
+#endif
+    return str_words_scalar(s);
+}
+
+int str_lower(char *s) {
+#ifdef MYSTRING_X86
+    int level = str_simd(-1);
+    if (level >= 2)
+        return str_lower_avx2(s, strlen(s));
+    if (level == 1)
+        return str_lower_sse2(s, strlen(s));
+#endif
+    return str_lower_scalar(s);
+}
+
+void str_trim(char *s) {
+#ifdef MYSTRING_X86
+    int level = str_simd(-1);
+    int n = (level >= 1) ? strlen(s) : 0;
+    if (n >= 64) {   // shorter strings have no whole block
+        if (level >= 2)
+            str_trim_avx2(s, n);
+        else
+            str_trim_sse2(s, n);
+        return;
+    }
+#endif
+    str_trim_scalar(s);
+}
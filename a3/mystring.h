@@ -5,4 +5,9 @@ int str_words(char *s);
 int str_lower(char *s);
 void str_trim(char *s);
 
+// Select the kernels of the functions above: 0 scalar, 1 SSE2, 2 AVX2,
+// capped at what the CPU supports; a negative level only queries.
+// Returns the level in use. The default is the best supported level.
+int str_simd(int level);
+
 #endif /* MYSTRING_H */
@@ -8,7 +8,9 @@
  */
 #include "mystring.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 
 #define MAX_LINE 10
@@ -60,10 +62,98 @@ void test_str_trim() {
 	printf("\n");
 }
 
+void test_str_simd() {
+	printf("------------------\n");
+	printf("Test: str_simd\n\n");
+	// long enough for whole vector blocks, with double spaces in some
+	char text[] = "  The Quick brown FOX, jumps over 2 lazy dogs.  Then it RUNS away  "
+			"to the   river bank and $100 worth of Fish. ";
+	int level = str_simd(-1);
+	int same = 1;
+	char dest[2][sizeof text];
+	int words[2], lower[2];
+	for (int k = 0; k < 2; k++) {
+		str_simd(k == 0 ? 0 : level);
+		strcpy(dest[k], text);
+		words[k] = str_words(dest[k]);
+		lower[k] = str_lower(dest[k]);
+		str_trim(dest[k]);
+	}
+	str_simd(level);
+	same = words[0] == words[1] && lower[0] == lower[1] && strcmp(dest[0], dest[1]) == 0;
+	printf("str_words:%d, str_lower:%d, str_trim:%s\n", words[1], lower[1], dest[1]);
+	printf("same as scalar: %d\n", same);
+	printf("\n");
+}
+
+/*
+ * Fill s with n bytes of words, mixed case, punctuation and some double spaces.
+ */
+void make_text(char *s, int n) {
+	for (int i = 0; i < n; i++) {
+		int r = rand() % 64;
+		s[i] = r < 9 ? ' ' : r < 10 ? ',' : r < 11 ? '.' : r < 22 ? 'A' + r % 26 : 'a' + r % 26;
+	}
+	s[n] = '\0';
+}
+
+double time_kernel(int op, char *src, char *dest, int n, int reps) {
+	clock_t t1 = clock();
+	int sink = 0;
+	for (int r = 0; r < reps; r++) {
+		if (op == 0) {
+			sink += str_words(src);
+		} else {
+			memcpy(dest, src, n + 1);
+			if (op == 1)
+				sink += str_lower(dest);
+			else
+				str_trim(dest);
+		}
+	}
+	double s = (double) (clock() - t1) / CLOCKS_PER_SEC;
+	if (sink == -1)
+		printf(" ");
+	return (double) n * reps / (s > 0 ? s : 1e-9) / 1e6;
+}
+
+void time_test_simd() {
+	printf("------------------\n");
+	printf("Test: runtime, MB/s (str_lower and str_trim include a copy)\n\n");
+	int sizes[] = { 32, 1000, 8 << 20 };
+	char *names[] = { "str_words", "str_lower", "str_trim" };
+	char *levels[] = { "scalar", "sse2", "avx2" };
+	int best = str_simd(-1);
+	char *src = malloc((8 << 20) + 1), *dest = malloc((8 << 20) + 1);
+	for (int k = 0; k < 3; k++) {
+		int n = sizes[k];
+		int reps = (64 << 20) / n;
+		make_text(src, n);
+		printf("%d bytes:\n", n);
+		for (int op = 0; op < 3; op++) {
+			printf("  %-10s", names[op]);
+			for (int level = 0; level <= best; level++) {
+				str_simd(level);
+				printf(" %s %8.0f", levels[level], time_kernel(op, src, dest, n, reps));
+			}
+			printf("\n");
+		}
+	}
+	str_simd(best);
+	free(src);
+	free(dest);
+	printf("\n");
+}
+
 int main(int argc, char* args[]) {
+	if (argc > 1) {
+		time_test_simd();
+		return 0;
+	}
 	test_str_words();
 	test_str_lower();
 	test_str_trim();	
+	test_str_simd();
 	return 0;
 }
 
@@ -2,6 +2,274 @@
 #include "mystring.h"  // For str_lower() and str_trim()
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static void *xrealloc(void *p, size_t size) {
+    p = realloc(p, size);
+    if (p == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed in myword\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+/*
+ * 64-bit FNV-1a hash of the first len characters of a word.
+ */
+static unsigned long long hash64(const char *word, int len) {
+    unsigned long long h = 14695981039346656037ull;
+    for (int i = 0; i < len; i++)
+        h = (h ^ (unsigned char)word[i]) * 1099511628211ull;
+    return h;
+}
+
+/*
+ * Second-level CHD hash: a splitmix64 finalizer of the word hash
+ * perturbed by the bucket seed.
+ */
+static unsigned int seeded_hash(unsigned long long h, unsigned int seed) {
+    h ^= (seed + 1) * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return (unsigned int)(h ^ (h >> 31));
+}
+
+/*
+ * WORDLIST: distinct words in a string pool, with an open-addressing
+ * set over them for de-duplication while a stop-word set is built.
+ */
+typedef struct {
+    char *pool;
+    int length, pool_capacity;
+    int *offset;
+    unsigned long long *hash;
+    int size, capacity;
+    int *index;             // slot -> word + 1, 0 = empty
+    int slots;
+} WORDLIST;
+
+static void wordlist_init(WORDLIST *list) {
+    memset(list, 0, sizeof(WORDLIST));
+    list->slots = 64;
+    list->index = (int *)calloc(list->slots, sizeof(int));
+    if (list->index == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed in myword\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void wordlist_clean(WORDLIST *list) {
+    free(list->pool);
+    free(list->offset);
+    free(list->hash);
+    free(list->index);
+    memset(list, 0, sizeof(WORDLIST));
+}
+
+/*
+ * Add a word of len characters if it is new.
+ * @return - TRUE if the word was added, FALSE if it was already present.
+ */
+static BOOLEAN wordlist_add(WORDLIST *list, const char *word, int len) {
+    unsigned long long h = hash64(word, len);
+    unsigned int mask = list->slots - 1;
+    unsigned int s = (unsigned int)h & mask;
+    while (list->index[s] != 0) {
+        int i = list->index[s] - 1;
+        const char *w = list->pool + list->offset[i];
+        if (list->hash[i] == h && strncmp(w, word, len) == 0 && w[len] == '\0')
+            return FALSE;
+        s = (s + 1) & mask;
+    }
+
+    if (list->length + len + 1 > list->pool_capacity) {
+        list->pool_capacity = 2 * (list->length + len + 1);
+        list->pool = (char *)xrealloc(list->pool, list->pool_capacity);
+    }
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity ? 2 * list->capacity : 64;
+        list->offset = (int *)xrealloc(list->offset, list->capacity * sizeof(int));
+        list->hash = (unsigned long long *)xrealloc(list->hash,
+                list->capacity * sizeof(unsigned long long));
+    }
+    int i = list->size++;
+    list->offset[i] = list->length;
+    list->hash[i] = h;
+    memcpy(list->pool + list->length, word, len);
+    list->length += len;
+    list->pool[list->length++] = '\0';
+    list->index[s] = i + 1;
+
+    if (2 * list->size > list->slots) {   // grow and reinsert
+        list->slots *= 2;
+        mask = list->slots - 1;
+        free(list->index);
+        list->index = (int *)calloc(list->slots, sizeof(int));
+        if (list->index == NULL) {
+            fprintf(stderr, "Error: Memory allocation failed in myword\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int j = 0; j < list->size; j++) {
+            s = (unsigned int)list->hash[j] & mask;
+            while (list->index[s] != 0)
+                s = (s + 1) & mask;
+            list->index[s] = j + 1;
+        }
+    }
+    return TRUE;
+}
+
+/*
+ * Build the CHD minimal perfect hash over the words of a WORDLIST and move
+ * its pool into the set. Buckets are placed largest first; each one gets
+ * the first seed that sends all its words to distinct free slots.
+ */
+static int stopwords_build(WORDLIST *list, STOPWORDS *sw) {
+    int n = list->size;
+    sw->size = n;
+    sw->buckets = n / 3 + 1;
+    sw->seed = (unsigned int *)xrealloc(NULL, sw->buckets * sizeof(unsigned int));
+    sw->offset = (int *)xrealloc(NULL, (n > 0 ? n : 1) * sizeof(int));
+    sw->pool = list->pool;
+    list->pool = NULL;
+
+    // words grouped by bucket: order[first[b] .. first[b+1])
+    int *first = (int *)calloc(sw->buckets + 1, sizeof(int));
+    int *order = (int *)xrealloc(NULL, (n > 0 ? n : 1) * sizeof(int));
+    int *bucket_order = (int *)xrealloc(NULL, sw->buckets * sizeof(int));
+    char *used = (char *)calloc(n > 0 ? n : 1, 1);
+    int *slot = (int *)xrealloc(NULL, (n > 0 ? n : 1) * sizeof(int));
+    if (first == NULL || used == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed in myword\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++)
+        first[(list->hash[i] >> 32) % sw->buckets + 1]++;
+    int max_size = 0;
+    for (int b = 0; b < sw->buckets; b++) {
+        if (first[b + 1] > max_size)
+            max_size = first[b + 1];
+        first[b + 1] += first[b];
+    }
+    int *fill = (int *)xrealloc(NULL, sw->buckets * sizeof(int));
+    memcpy(fill, first, sw->buckets * sizeof(int));
+    for (int i = 0; i < n; i++)
+        order[fill[(list->hash[i] >> 32) % sw->buckets]++] = i;
+
+    // counting sort of the buckets by descending size
+    int k = 0;
+    for (int m = max_size; m >= 0; m--) {
+        for (int b = 0; b < sw->buckets; b++) {
+            if (first[b + 1] - first[b] == m)
+                bucket_order[k++] = b;
+        }
+    }
+
+    for (int j = 0; j < sw->buckets; j++) {
+        int b = bucket_order[j];
+        int m = first[b + 1] - first[b];
+        unsigned int seed = 0;
+        for (;; seed++) {
+            int ok = 1;
+            for (int t = 0; t < m && ok; t++) {
+                slot[t] = seeded_hash(list->hash[order[first[b] + t]], seed) % n;
+                ok = !used[slot[t]];
+                for (int u = 0; u < t && ok; u++)
+                    ok = (slot[u] != slot[t]);
+            }
+            if (ok)
+                break;
+        }
+        sw->seed[b] = seed;
+        for (int t = 0; t < m; t++) {
+            used[slot[t]] = 1;
+            sw->offset[slot[t]] = list->offset[order[first[b] + t]];
+        }
+    }
+
+    free(first);
+    free(fill);
+    free(order);
+    free(bucket_order);
+    free(used);
+    free(slot);
+    wordlist_clean(list);
+    return n;
+}
+
+/*
+ * Split on whitespace and commas while reading character by character,
+ * so neither line nor word length is limited.
+ */
+int stopwords_load(FILE *fp, STOPWORDS *stopwords) {
+    if (!fp || !stopwords) {
+        printf("Error: Null file pointer or stop-word set\n");
+        return 0;
+    }
+    fseek(fp, 0, SEEK_SET);
+
+    WORDLIST list;
+    wordlist_init(&list);
+    char *word = NULL;
+    int len = 0, capacity = 0, c;
+    do {
+        c = fgetc(fp);
+        if (c == EOF || c == ',' || c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            if (len > 0)
+                wordlist_add(&list, word, len);
+            len = 0;
+        } else {
+            if (len == capacity) {
+                capacity = capacity ? 2 * capacity : 32;
+                word = (char *)xrealloc(word, capacity);
+            }
+            word[len++] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+        }
+    } while (c != EOF);
+    free(word);
+    return stopwords_build(&list, stopwords);
+}
+
+int stopwords_compile(char *dictionary, STOPWORDS *stopwords) {
+    WORDLIST list;
+    wordlist_init(&list);
+    char *p = dictionary;
+    while (p != NULL && *p) {
+        while (*p == ' ')
+            p++;
+        char *start = p;
+        while (*p && *p != ' ')
+            p++;
+        if (p > start)
+            wordlist_add(&list, start, p - start);
+    }
+    return stopwords_build(&list, stopwords);
+}
+
+/*
+ * Hash the word once, find its bucket seed, then compare with the one
+ * word stored in its slot.
+ */
+BOOLEAN stopwords_contain(STOPWORDS *stopwords, char *word) {
+    if (stopwords->size == 0)
+        return FALSE;
+    unsigned long long h = hash64(word, strlen(word));
+    unsigned int s = seeded_hash(h, stopwords->seed[(h >> 32) % stopwords->buckets])
+            % stopwords->size;
+    return (strcmp(stopwords->pool + stopwords->offset[s], word) == 0) ? TRUE : FALSE;
+}
+
+void stopwords_clean(STOPWORDS *stopwords) {
+    free(stopwords->pool);
+    free(stopwords->offset);
+    free(stopwords->seed);
+    memset(stopwords, 0, sizeof(STOPWORDS));
+}
 
 /*
  * create_dictionary()
@@ -10,6 +278,7 @@
  * Each token (stop word) is converted to lowercase and, if not already
  * in the dictionary, is appended (with a leading and trailing space for
  * exact matching). We call fseek() to ensure the file pointer is at the beginning.
+ * Duplicates are detected with a hash set, so building is linear.
  */
 int create_dictionary(FILE *fp, char *dictionary) {
     char line[MAX_LINE_LEN];
@@ -25,6 +294,9 @@ int create_dictionary(FILE *fp, char *dictionary) {
     
     // Initialize the dictionary as an empty string.
     dictionary[0] = '\0';
+    int length = 0;
+    WORDLIST seen;  // Hash set of the words added so far, for de-duplication
+    wordlist_init(&seen);
     
     // Read each line from the file.
     while (fgets(line, sizeof(line), fp)) {
@@ -33,21 +305,27 @@ int create_dictionary(FILE *fp, char *dictionary) {
         while (token != NULL) {
             // Convert the token to lowercase.
             str_lower(token);
+            int n = strlen(token);
             // If the word is not already in the dictionary, add it.
-            if (!contain_word(dictionary, token)) {
-                if (strlen(dictionary) + strlen(token) + 3 >= MAX_DICT_SIZE) {
+            if (wordlist_add(&seen, token, n)) {
+                if (length + n + 3 >= MAX_DICT_SIZE) {
                     printf("Warning: Dictionary buffer full, truncating.\n");
+                    wordlist_clean(&seen);
                     return word_count;
                 }
-                strcat(dictionary, " ");  // Leading space for exact matching
-                strcat(dictionary, token);
-                strcat(dictionary, " ");  // Trailing space
+                // Leading and trailing space for exact matching
+                dictionary[length++] = ' ';
+                memcpy(dictionary + length, token, n);
+                length += n;
+                dictionary[length++] = ' ';
+                dictionary[length] = '\0';
                 word_count++;
             }
             token = strtok(NULL, " \t\n\r");
         }
     }
     
+    wordlist_clean(&seen);
     return word_count;
 }
 
@@ -69,56 +347,665 @@ BOOLEAN contain_word(char *dictionary, char *word) {
 }
 
 /*
- * process_words()
- * ---------------
- * Reads the input text file line by line, trims and lowercases the line,
- * tokenizes it into words, and:
- *   - Increments the total word count.
- *   - For tokens that are not stop words, adds them (or updates their frequency)
- *     in the keyword array.
+ * FNV-1a hash of the first MAX_WORD_LEN - 1 characters of a word;
+ * *len receives the hashed length.
  */
-WORDSTATS process_words(FILE *fp, WORD *words, char *dictionary) {
+static unsigned int word_hash(const char *word, int *len) {
+    unsigned int h = 2166136261u;
+    int n = 0;
+    while (n < MAX_WORD_LEN - 1 && word[n]) {
+        h = (h ^ (unsigned char)word[n]) * 16777619u;
+        n++;
+    }
+    *len = n;
+    return h;
+}
+
+/*
+ * Rebuild the hash index with the given number of slots from the stored hashes.
+ */
+static void wordtable_rehash(WORDTABLE *table, int slots) {
+    free(table->index);
+    table->index = (int *)calloc(slots, sizeof(int));
+    if (table->index == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed in WORDTABLE\n");
+        exit(EXIT_FAILURE);
+    }
+    table->slots = slots;
+    for (int i = 0; i < table->size; i++) {
+        unsigned int s = table->hash[i] & (slots - 1);
+        while (table->index[s] != 0)
+            s = (s + 1) & (slots - 1);
+        table->index[s] = i + 1;
+    }
+}
+
+void wordtable_init(WORDTABLE *table, int capacity) {
+    if (capacity <= 0)
+        capacity = WORDTABLE_INIT;
+    table->size = 0;
+    table->capacity = capacity;
+    table->words = (WORD *)xrealloc(NULL, capacity * sizeof(WORD));
+    table->hash = (unsigned int *)xrealloc(NULL, capacity * sizeof(unsigned int));
+    table->index = NULL;
+    int slots = 16;
+    while (slots < 2 * capacity)
+        slots *= 2;
+    wordtable_rehash(table, slots);
+}
+
+/*
+ * Linear probing from the word's home slot; returns the slot holding the
+ * word, or the empty slot where it would go.
+ */
+static unsigned int wordtable_probe(WORDTABLE *table, const char *word, int len, unsigned int h) {
+    unsigned int mask = table->slots - 1;
+    unsigned int s = h & mask;
+    while (table->index[s] != 0) {
+        int i = table->index[s] - 1;
+        if (table->hash[i] == h && strncmp(table->words[i].word, word, len) == 0
+                && table->words[i].word[len] == '\0')
+            break;
+        s = (s + 1) & mask;
+    }
+    return s;
+}
+
+int wordtable_add(WORDTABLE *table, char *word, int count) {
+    int len;
+    unsigned int h = word_hash(word, &len);
+    unsigned int s = wordtable_probe(table, word, len, h);
+    if (table->index[s] != 0) {
+        table->words[table->index[s] - 1].count += count;
+        return table->index[s] - 1;
+    }
+
+    if (table->size == table->capacity) {
+        table->capacity *= 2;
+        table->words = (WORD *)xrealloc(table->words, table->capacity * sizeof(WORD));
+        table->hash = (unsigned int *)xrealloc(table->hash, table->capacity * sizeof(unsigned int));
+    }
+    int i = table->size++;
+    memcpy(table->words[i].word, word, len);
+    table->words[i].word[len] = '\0';
+    table->words[i].count = count;
+    table->hash[i] = h;
+    if (2 * table->size > table->slots)   // keep the load factor at most 1/2
+        wordtable_rehash(table, 2 * table->slots);
+    else
+        table->index[s] = i + 1;
+    return i;
+}
+
+WORD *wordtable_find(WORDTABLE *table, char *word) {
+    int len;
+    unsigned int h = word_hash(word, &len);
+    unsigned int s = wordtable_probe(table, word, len, h);
+    return (table->index[s] != 0) ? &table->words[table->index[s] - 1] : NULL;
+}
+
+/*
+ * Heap order for top-K: a is "smaller" than b if it has a lower count,
+ * or the same count and a later first occurrence.
+ */
+static int word_before(WORDTABLE *table, int a, int b) {
+    if (table->words[a].count != table->words[b].count)
+        return table->words[a].count < table->words[b].count;
+    return a > b;
+}
+
+static void heap_down(WORDTABLE *table, int *heap, int n, int i) {
+    for (;;) {
+        int m = i, l = 2 * i + 1, r = l + 1;
+        if (l < n && word_before(table, heap[l], heap[m]))
+            m = l;
+        if (r < n && word_before(table, heap[r], heap[m]))
+            m = r;
+        if (m == i)
+            return;
+        int t = heap[i];
+        heap[i] = heap[m];
+        heap[m] = t;
+        i = m;
+    }
+}
+
+/*
+ * Keep the k best positions in a min-heap whose root is the weakest,
+ * then pop the heap from the back of top to the front.
+ */
+int wordtable_top(WORDTABLE *table, WORD *top, int k) {
+    if (k > table->size)
+        k = table->size;
+    if (k <= 0)
+        return 0;
+    int *heap = (int *)xrealloc(NULL, k * sizeof(int));
+    for (int i = 0; i < k; i++)
+        heap[i] = i;
+    for (int i = k / 2 - 1; i >= 0; i--)
+        heap_down(table, heap, k, i);
+    for (int i = k; i < table->size; i++) {
+        if (word_before(table, heap[0], i)) {
+            heap[0] = i;
+            heap_down(table, heap, k, 0);
+        }
+    }
+    for (int n = k; n > 0; n--) {
+        top[n - 1] = table->words[heap[0]];
+        heap[0] = heap[n - 1];
+        heap_down(table, heap, n - 1, 0);
+    }
+    free(heap);
+    return k;
+}
+
+void wordtable_clean(WORDTABLE *table) {
+    free(table->words);
+    free(table->hash);
+    free(table->index);
+    table->words = NULL;
+    table->hash = NULL;
+    table->index = NULL;
+    table->size = table->capacity = table->slots = 0;
+}
+
+/*
+ * process_words_stopwords()
+ * -------------------------
+ * Same line handling and tokenization as process_words(), with stop words
+ * looked up in the compiled set and every keyword counted in the hash table.
+ */
+WORDSTATS process_words_stopwords(FILE *fp, WORDTABLE *table, STOPWORDS *stopwords) {
     WORDSTATS stats = {0, 0, 0};
     char line[MAX_LINE_LEN];
     char *token;
     
-    if (!fp || !words || !dictionary) {
-        printf("Error: Null pointer detected in process_words\n");
+    if (!fp || !table || !stopwords) {
+        printf("Error: Null pointer detected in process_words_stopwords\n");
         return stats;
     }
     
     while (fgets(line, sizeof(line), fp)) {
         stats.line_count++;
-        str_trim(line);  // Remove extra spaces
-        str_lower(line); // Convert the entire line to lowercase
+        str_trim(line);
+        str_lower(line);
         
-        // Tokenize the line using common delimiters.
         token = strtok(line, " ,.\t\n");
         while (token != NULL) {
             stats.word_count++;
-            
-            // Only process the token if it is not a stop word.
-            if (!contain_word(dictionary, token)) {
-                int found = FALSE;
-                // Check if the token is already present in the keywords array.
-                for (int i = 0; i < stats.keyword_count; i++) {
-                    if (strcmp(words[i].word, token) == 0) {
-                        words[i].count++;
-                        found = TRUE;
-                        break;
-                    }
-                }
-                // If the token is new and there is space in the array, add it.
-                if (!found && stats.keyword_count < MAX_WORDS) {
-                    strncpy(words[stats.keyword_count].word, token, MAX_WORD_LEN - 1);
-                    words[stats.keyword_count].word[MAX_WORD_LEN - 1] = '\0';
-                    words[stats.keyword_count].count = 1;
-                    stats.keyword_count++;
+            if (!stopwords_contain(stopwords, token))
+                wordtable_add(table, token, 1);
+            token = strtok(NULL, " ,.\t\n");
+        }
+    }
+    stats.keyword_count = table->size;
+    return stats;
+}
+
+WORDSTATS process_words_table(FILE *fp, WORDTABLE *table, char *dictionary) {
+    WORDSTATS stats = {0, 0, 0};
+    
+    if (!fp || !table || !dictionary) {
+        printf("Error: Null pointer detected in process_words_table\n");
+        return stats;
+    }
+    
+    STOPWORDS stopwords;
+    stopwords_compile(dictionary, &stopwords);
+    stats = process_words_stopwords(fp, table, &stopwords);
+    stopwords_clean(&stopwords);
+    return stats;
+}
+
+#define NGRAM_BASE 0x9E3779B1u   // multiplier of the rolling n-gram hash
+
+/*
+ * Rolling polynomial hash of n token IDs, sum of (id + 1) * BASE^(n-1-i),
+ * mixed before it selects a slot.
+ */
+static unsigned int ngram_hash(int *ids, int n) {
+    unsigned int h = 0;
+    for (int i = 0; i < n; i++)
+        h = h * NGRAM_BASE + (unsigned int)ids[i] + 1;
+    return h;
+}
+
+static unsigned int ngram_slot(unsigned int h, int slots) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return h & (slots - 1);
+}
+
+static void ngrams_rehash(NGRAMS *ngrams, int slots) {
+    free(ngrams->index);
+    ngrams->index = (int *)calloc(slots, sizeof(int));
+    if (ngrams->index == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed in myword\n");
+        exit(EXIT_FAILURE);
+    }
+    ngrams->slots = slots;
+    for (int i = 0; i < ngrams->size; i++) {
+        unsigned int s = ngram_slot(ngrams->hash[i], slots);
+        while (ngrams->index[s] != 0)
+            s = (s + 1) & (slots - 1);
+        ngrams->index[s] = i + 1;
+    }
+}
+
+void ngrams_init(NGRAMS *ngrams, int n, int capacity) {
+    memset(ngrams, 0, sizeof(NGRAMS));
+    ngrams->n = (n < 1) ? 1 : (n > NGRAM_MAX) ? NGRAM_MAX : n;
+    ngrams->capacity = (capacity > 0) ? capacity : 0;
+    ngrams->allocated = (capacity > 0) ? capacity : WORDTABLE_INIT;
+    ngrams->grams = (NGRAM *)xrealloc(NULL, ngrams->allocated * sizeof(NGRAM));
+    ngrams->hash = (unsigned int *)xrealloc(NULL, ngrams->allocated * sizeof(unsigned int));
+    if (capacity > 0) {
+        ngrams->heap = (int *)xrealloc(NULL, capacity * sizeof(int));
+        ngrams->where = (int *)xrealloc(NULL, capacity * sizeof(int));
+    }
+    int slots = 16;
+    while (slots < 2 * ngrams->allocated)
+        slots *= 2;
+    ngrams_rehash(ngrams, slots);
+}
+
+/*
+ * Space-saving min-heap on count; where[] follows every move.
+ */
+static void ngram_heap_swap(NGRAMS *ngrams, int a, int b) {
+    int t = ngrams->heap[a];
+    ngrams->heap[a] = ngrams->heap[b];
+    ngrams->heap[b] = t;
+    ngrams->where[ngrams->heap[a]] = a;
+    ngrams->where[ngrams->heap[b]] = b;
+}
+
+static void ngram_heap_down(NGRAMS *ngrams, int i) {
+    NGRAM *g = ngrams->grams;
+    int *heap = ngrams->heap;
+    for (;;) {
+        int m = i, l = 2 * i + 1, r = l + 1;
+        if (l < ngrams->size && g[heap[l]].count < g[heap[m]].count)
+            m = l;
+        if (r < ngrams->size && g[heap[r]].count < g[heap[m]].count)
+            m = r;
+        if (m == i)
+            return;
+        ngram_heap_swap(ngrams, i, m);
+        i = m;
+    }
+}
+
+/*
+ * Remove the n-gram at position i from the hash index by backward-shift
+ * deletion, so that no tombstones are needed.
+ */
+static void ngram_unindex(NGRAMS *ngrams, int i) {
+    unsigned int mask = ngrams->slots - 1;
+    unsigned int s = ngram_slot(ngrams->hash[i], ngrams->slots);
+    while (ngrams->index[s] != i + 1)
+        s = (s + 1) & mask;
+    unsigned int hole = s;
+    for (s = (s + 1) & mask; ngrams->index[s] != 0; s = (s + 1) & mask) {
+        unsigned int home = ngram_slot(ngrams->hash[ngrams->index[s] - 1], ngrams->slots);
+        // move the entry into the hole unless its home lies in (hole, s]
+        if (((s - home) & mask) >= ((s - hole) & mask)) {
+            ngrams->index[hole] = ngrams->index[s];
+            hole = s;
+        }
+    }
+    ngrams->index[hole] = 0;
+}
+
+/*
+ * Count the n-gram ids with its precomputed hash h.
+ */
+static void ngrams_insert(NGRAMS *ngrams, int *ids, unsigned int h) {
+    int n = ngrams->n;
+    unsigned int mask = ngrams->slots - 1;
+    unsigned int s = ngram_slot(h, ngrams->slots);
+    ngrams->total++;
+    while (ngrams->index[s] != 0) {
+        int i = ngrams->index[s] - 1;
+        if (ngrams->hash[i] == h && memcmp(ngrams->grams[i].id, ids, n * sizeof(int)) == 0) {
+            ngrams->grams[i].count++;
+            if (ngrams->capacity > 0)
+                ngram_heap_down(ngrams, ngrams->where[i]);
+            return;
+        }
+        s = (s + 1) & mask;
+    }
+
+    int i;
+    if (ngrams->capacity > 0 && ngrams->size == ngrams->capacity) {
+        // replace the minimum: it keeps its heap position, count grows by one
+        i = ngrams->heap[0];
+        ngram_unindex(ngrams, i);
+        NGRAM *g = &ngrams->grams[i];
+        g->error = g->count;
+        g->count++;
+        memset(g->id, -1, sizeof g->id);
+        memcpy(g->id, ids, n * sizeof(int));
+        ngrams->hash[i] = h;
+        s = ngram_slot(h, ngrams->slots);
+        while (ngrams->index[s] != 0)
+            s = (s + 1) & mask;
+        ngrams->index[s] = i + 1;
+        ngram_heap_down(ngrams, 0);
+        return;
+    }
+
+    if (ngrams->size == ngrams->allocated) {
+        ngrams->allocated *= 2;
+        ngrams->grams = (NGRAM *)xrealloc(ngrams->grams, ngrams->allocated * sizeof(NGRAM));
+        ngrams->hash = (unsigned int *)xrealloc(ngrams->hash,
+                ngrams->allocated * sizeof(unsigned int));
+    }
+    i = ngrams->size++;
+    NGRAM *g = &ngrams->grams[i];
+    memset(g->id, -1, sizeof g->id);
+    memcpy(g->id, ids, n * sizeof(int));
+    g->count = 1;
+    g->error = 0;
+    ngrams->hash[i] = h;
+    ngrams->index[s] = i + 1;
+    if (ngrams->capacity > 0) {
+        ngrams->heap[i] = i;
+        ngrams->where[i] = i;
+        for (int j = i; j > 0 && ngrams->grams[ngrams->heap[(j - 1) / 2]].count > 1; j = (j - 1) / 2)
+            ngram_heap_swap(ngrams, j, (j - 1) / 2);
+    }
+    if (2 * ngrams->size > ngrams->slots)
+        ngrams_rehash(ngrams, 2 * ngrams->slots);
+}
+
+void ngrams_add(NGRAMS *ngrams, int *ids) {
+    ngrams_insert(ngrams, ids, ngram_hash(ids, ngrams->n));
+}
+
+/*
+ * Heap order for top-K: a is weaker than b if it has a lower count, or
+ * the same count and a later position.
+ */
+static int ngram_before(NGRAM *g, int a, int b) {
+    if (g[a].count != g[b].count)
+        return g[a].count < g[b].count;
+    return a > b;
+}
+
+static void ngram_top_down(NGRAM *g, int *heap, int n, int i) {
+    for (;;) {
+        int m = i, l = 2 * i + 1, r = l + 1;
+        if (l < n && ngram_before(g, heap[l], heap[m]))
+            m = l;
+        if (r < n && ngram_before(g, heap[r], heap[m]))
+            m = r;
+        if (m == i)
+            return;
+        int t = heap[i];
+        heap[i] = heap[m];
+        heap[m] = t;
+        i = m;
+    }
+}
+
+/*
+ * Same selection as wordtable_top(): a k-element min-heap of the best.
+ */
+int ngram_top(NGRAMS *ngrams, NGRAM *top, int k) {
+    if (k > ngrams->size)
+        k = ngrams->size;
+    if (k <= 0)
+        return 0;
+    NGRAM *g = ngrams->grams;
+    int *heap = (int *)xrealloc(NULL, k * sizeof(int));
+    for (int i = 0; i < k; i++)
+        heap[i] = i;
+    for (int i = k / 2 - 1; i >= 0; i--)
+        ngram_top_down(g, heap, k, i);
+    for (int i = k; i < ngrams->size; i++) {
+        if (ngram_before(g, heap[0], i)) {
+            heap[0] = i;
+            ngram_top_down(g, heap, k, 0);
+        }
+    }
+    for (int n = k; n > 0; n--) {
+        top[n - 1] = g[heap[0]];
+        heap[0] = heap[n - 1];
+        ngram_top_down(g, heap, n - 1, 0);
+    }
+    free(heap);
+    return k;
+}
+
+void ngrams_clean(NGRAMS *ngrams) {
+    free(ngrams->grams);
+    free(ngrams->hash);
+    free(ngrams->index);
+    free(ngrams->heap);
+    free(ngrams->where);
+    memset(ngrams, 0, sizeof(NGRAMS));
+}
+
+/*
+ * process_ngrams()
+ * ----------------
+ * Same line handling as process_words(). The IDs of the last n keywords
+ * of the current line are kept in a window with their rolling hash: the
+ * oldest ID leaves with its BASE^(n-1) term, the new one enters as the
+ * lowest term. Every keyword after the first n-1 of a line completes an
+ * n-gram.
+ */
+WORDSTATS process_ngrams(FILE *fp, WORDTABLE *table, NGRAMS *ngrams, char *dictionary) {
+    WORDSTATS stats = {0, 0, 0};
+    char line[MAX_LINE_LEN];
+    char *token;
+    
+    if (!fp || !table || !ngrams || !dictionary) {
+        printf("Error: Null pointer detected in process_ngrams\n");
+        return stats;
+    }
+    
+    STOPWORDS stopwords;
+    stopwords_compile(dictionary, &stopwords);
+    int n = ngrams->n;
+    int window[NGRAM_MAX];
+    unsigned int top_power = 1;   // BASE^(n-1)
+    for (int i = 1; i < n; i++)
+        top_power *= NGRAM_BASE;
+    while (fgets(line, sizeof(line), fp)) {
+        stats.line_count++;
+        str_trim(line);
+        str_lower(line);
+        
+        int filled = 0;
+        unsigned int h = 0;
+        token = strtok(line, " ,.\t\n");
+        while (token != NULL) {
+            stats.word_count++;
+            if (!stopwords_contain(&stopwords, token)) {
+                int id = wordtable_add(table, token, 1);
+                if (filled == n) {
+                    h -= ((unsigned int)window[0] + 1) * top_power;
+                    memmove(window, window + 1, (n - 1) * sizeof(int));
+                    filled--;
                 }
+                window[filled++] = id;
+                h = h * NGRAM_BASE + (unsigned int)id + 1;
+                if (filled == n)
+                    ngrams_insert(ngrams, window, h);
             }
             token = strtok(NULL, " ,.\t\n");
         }
     }
+    stopwords_clean(&stopwords);
+    stats.keyword_count = table->size;
+    return stats;
+}
+
+/*
+ * A chunk of the mapped file and the statistics of its worker.
+ */
+typedef struct {
+    const char *start, *end;
+    STOPWORDS *stopwords;
+    WORDTABLE table;
+    WORDSTATS stats;
+} WORDCHUNK;
+
+/*
+ * The strtok() delimiters of process_words().
+ */
+static int is_delimiter(char c) {
+    return c == ' ' || c == ',' || c == '.' || c == '\t' || c == '\n';
+}
+
+/*
+ * Count the lines and tokens of one chunk; each token is lowercased into
+ * a growable buffer since the mapping is read-only.
+ */
+static void *count_chunk(void *arg) {
+    WORDCHUNK *chunk = (WORDCHUNK *)arg;
+    const char *p = chunk->start, *end = chunk->end;
+    int capacity = 64;
+    char *token = (char *)xrealloc(NULL, capacity);
+
+    for (const char *q = p; (q = memchr(q, '\n', end - q)) != NULL; q++)
+        chunk->stats.line_count++;
+    while (p < end) {
+        while (p < end && is_delimiter(*p))
+            p++;
+        if (p == end)
+            break;
+        const char *t = p;
+        while (p < end && !is_delimiter(*p))
+            p++;
+        int len = p - t;
+        if (len >= capacity) {
+            capacity = 2 * len;
+            token = (char *)xrealloc(token, capacity);
+        }
+        for (int i = 0; i < len; i++)
+            token[i] = (t[i] >= 'A' && t[i] <= 'Z') ? t[i] + ('a' - 'A') : t[i];
+        token[len] = '\0';
+        chunk->stats.word_count++;
+        if (!stopwords_contain(chunk->stopwords, token))
+            wordtable_add(&chunk->table, token, 1);
+    }
+    free(token);
+    return NULL;
+}
+
+/*
+ * process_words_mmap()
+ * --------------------
+ * Maps the file read-only, cuts it into nthreads pieces, moves every cut
+ * forward to just after the next newline, runs count_chunk() on each piece
+ * (the first one on the calling thread) and merges the chunk tables in order.
+ * A final line without a newline counts as a line, as with fgets().
+ */
+WORDSTATS process_words_mmap(char *filename, WORDTABLE *table, STOPWORDS *stopwords, int nthreads) {
+    WORDSTATS stats = {0, 0, 0};
+    
+    if (!filename || !table || !stopwords) {
+        printf("Error: Null pointer detected in process_words_mmap\n");
+        return stats;
+    }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("open input file error");
+        return stats;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        stats.keyword_count = table->size;
+        return stats;
+    }
+    size_t size = st.st_size;
+    char *data = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap input file error");
+        return stats;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    if (nthreads < 1)
+        nthreads = 1;
+    if ((size_t)nthreads > size)
+        nthreads = size;
+    WORDCHUNK *chunks = (WORDCHUNK *)xrealloc(NULL, nthreads * sizeof(WORDCHUNK));
+    pthread_t *threads = (pthread_t *)xrealloc(NULL, nthreads * sizeof(pthread_t));
+    const char *start = data, *end = data + size;
+    for (int i = 0; i < nthreads; i++) {
+        const char *cut = (i == nthreads - 1) ? end : data + size / nthreads * (i + 1);
+        if (cut < start)
+            cut = start;
+        if (cut < end) {
+            const char *nl = memchr(cut, '\n', end - cut);
+            cut = (nl != NULL) ? nl + 1 : end;
+        }
+        chunks[i].start = start;
+        chunks[i].end = cut;
+        chunks[i].stopwords = stopwords;
+        chunks[i].stats = stats;
+        wordtable_init(&chunks[i].table, 0);
+        start = cut;
+    }
+
+    // a chunk whose thread cannot be started is counted here instead
+    int started = 1;
+    while (started < nthreads
+            && pthread_create(&threads[started], NULL, count_chunk, &chunks[started]) == 0)
+        started++;
+    for (int i = started; i < nthreads; i++)
+        count_chunk(&chunks[i]);
+    count_chunk(&chunks[0]);
+    for (int i = 1; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    for (int i = 0; i < nthreads; i++) {
+        stats.line_count += chunks[i].stats.line_count;
+        stats.word_count += chunks[i].stats.word_count;
+        for (int j = 0; j < chunks[i].table.size; j++)
+            wordtable_add(table, chunks[i].table.words[j].word, chunks[i].table.words[j].count);
+        wordtable_clean(&chunks[i].table);
+    }
+    if (data[size - 1] != '\n')
+        stats.line_count++;
+    stats.keyword_count = table->size;
+
+    free(chunks);
+    free(threads);
+    munmap(data, size);
+    return stats;
+}
+
+/*
+ * process_words()
+ * ---------------
+ * Counts the keywords with process_words_table() and copies the first
+ * MAX_WORDS distinct keywords, in first-seen order, into the keyword array.
+ * Later keywords are dropped as before, but the counts of the kept ones
+ * remain exact.
+ */
+WORDSTATS process_words(FILE *fp, WORD *words, char *dictionary) {
+    WORDSTATS stats = {0, 0, 0};
+    
+    if (!fp || !words || !dictionary) {
+        printf("Error: Null pointer detected in process_words\n");
+        return stats;
+    }
+    
+    WORDTABLE table;
+    wordtable_init(&table, 0);
+    stats = process_words_table(fp, &table, dictionary);
+    if (stats.keyword_count > MAX_WORDS)
+        stats.keyword_count = MAX_WORDS;
+    memcpy(words, table.words, stats.keyword_count * sizeof(WORD));
+    wordtable_clean(&table);
     
     return stats;
 }
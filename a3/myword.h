@@ -7,6 +7,8 @@
 #define MAX_DICT_SIZE 4096    // Maximum size for dictionary storage (increased to hold all stop words)
 #define MAX_WORDS 5000        // Maximum number of distinct keywords
 #define MAX_LINE_LEN 1000     // Maximum length of a line from the input text
+#define WORDTABLE_INIT 64     // Initial capacity of a WORDTABLE
+#define NGRAM_MAX 3           // Longest n-gram counted by NGRAMS
 
 // Define enumeration type BOOLEAN with FALSE=0 and TRUE=1.
 typedef enum { FALSE = 0, TRUE = 1 } BOOLEAN;
@@ -24,6 +26,60 @@ typedef struct {
     int keyword_count; // Number of distinct non-common (non-stop) words
 } WORDSTATS;
 
+// Define structure type WORDTABLE, a growable keyword counter.
+// words[0..size-1] holds the distinct words in first-seen order; index is an
+// open-addressing hash table of slots entries (a power of two) holding
+// word positions + 1, with 0 marking an empty slot.
+typedef struct {
+    int size;              // Number of distinct words
+    int capacity;          // Allocated length of words and hash
+    WORD *words;           // Words and their counts
+    unsigned int *hash;    // Hash value of each word
+    int slots;             // Length of index
+    int *index;            // Hash slots
+} WORDTABLE;
+
+// Define structure type NGRAM to store an n-gram of keyword IDs (positions
+// in a WORDTABLE) and its frequency. In space-saving mode count may
+// over-estimate the true frequency by at most error.
+typedef struct {
+    int id[NGRAM_MAX];
+    int count;
+    int error;
+} NGRAM;
+
+// Define structure type NGRAMS, a counter of n-grams of keyword IDs.
+// With capacity 0 every distinct n-gram is kept (exact mode); otherwise at
+// most capacity n-grams are kept with the space-saving algorithm: a new
+// n-gram replaces the one with the smallest count and inherits that count.
+// grams are indexed by an open-addressing hash table of slots entries and,
+// in space-saving mode, ordered by count in the min-heap heap.
+typedef struct {
+    int n;                 // Tokens per n-gram, 1..NGRAM_MAX
+    int capacity;          // Maximum number of n-grams, 0 for no limit
+    int size;              // Number of n-grams kept
+    int allocated;         // Allocated length of grams and hash
+    NGRAM *grams;
+    unsigned int *hash;    // Rolling hash of each n-gram
+    int slots;             // Length of index, a power of two
+    int *index;            // Hash slots, n-gram position + 1, 0 = empty
+    int *heap;             // Space-saving min-heap of n-gram positions
+    int *where;            // Heap position of each n-gram
+    long long total;       // Number of n-grams counted
+} NGRAMS;
+
+// Define structure type STOPWORDS, a compiled stop-word set.
+// The words are stored back to back in pool; a CHD minimal perfect hash
+// maps each word to one of size slots: bucket = h % buckets, then
+// slot = hash seeded with seed[bucket] % size.
+typedef struct {
+    int size;              // Number of distinct stop words
+    char *pool;            // NUL-terminated words
+    int *offset;           // Pool offset of the word in each slot
+    int buckets;           // Number of CHD buckets
+    unsigned int *seed;    // Displacement seed of each bucket
+} STOPWORDS;
+
 /*
  * Load stop-word data from file into a dictionary.
  * The dictionary is stored in a char array as a sequence of stop words,
@@ -44,6 +100,42 @@ int create_dictionary(FILE *fp, char *dictionary);
  */
 BOOLEAN contain_word(char *dictionary, char *word);
 
+/*
+ * Load stop words from file into a compiled set. Words may be separated
+ * by whitespace or commas; they are lowercased and duplicates are dropped.
+ * There is no limit on the number or length of the words.
+ *
+ * @param fp - FILE pointer to an opened stop-word file.
+ * @param stopwords - the set to build; release it with stopwords_clean().
+ * @return - the number of distinct stop words.
+ */
+int stopwords_load(FILE *fp, STOPWORDS *stopwords);
+
+/*
+ * Compile a space-delimited dictionary string from create_dictionary()
+ * into a stop-word set.
+ *
+ * @param dictionary - the dictionary string.
+ * @param stopwords - the set to build; release it with stopwords_clean().
+ * @return - the number of distinct stop words.
+ */
+int stopwords_compile(char *dictionary, STOPWORDS *stopwords);
+
+/*
+ * Determine if a word is in a stop-word set, with one hash and one
+ * string comparison and no allocation.
+ *
+ * @param stopwords - the compiled set.
+ * @param word - the word to search for.
+ * @return - TRUE if the word is found, FALSE otherwise.
+ */
+BOOLEAN stopwords_contain(STOPWORDS *stopwords, char *word);
+
+/*
+ * Free the memory of a stop-word set.
+ */
+void stopwords_clean(STOPWORDS *stopwords);
+
 /*
  * Process text data from a file to compute word statistics:
  * number of lines, total words, and distinct keywords (non-stop words)
@@ -56,4 +148,128 @@ BOOLEAN contain_word(char *dictionary, char *word);
  */
 WORDSTATS process_words(FILE *fp, WORD *words, char *dictionary);
 
+/*
+ * Initialize an empty WORDTABLE.
+ *
+ * @param table - the table to initialize.
+ * @param capacity - expected number of distinct words, 0 for WORDTABLE_INIT.
+ */
+void wordtable_init(WORDTABLE *table, int capacity);
+
+/*
+ * Add count occurrences of a word, inserting it if it is new.
+ * Words are truncated to MAX_WORD_LEN - 1 characters as in process_words().
+ *
+ * @param table - the table.
+ * @param word - the word.
+ * @param count - number of occurrences to add.
+ * @return - the position of the word in table->words.
+ */
+int wordtable_add(WORDTABLE *table, char *word, int count);
+
+/*
+ * Look up a word in the table.
+ *
+ * @param table - the table.
+ * @param word - the word to search for.
+ * @return - pointer to its WORD entry, or NULL if it is not in the table.
+ */
+WORD *wordtable_find(WORDTABLE *table, char *word);
+
+/*
+ * Extract the k most frequent words in O(size log k) with a min-heap.
+ *
+ * @param table - the table.
+ * @param top - WORD array of length k to receive the words, by descending
+ *              count, ties in first-seen order.
+ * @param k - the number of words wanted.
+ * @return - the number of words stored in top, min(k, size).
+ */
+int wordtable_top(WORDTABLE *table, WORD *top, int k);
+
+/*
+ * Free the memory of a WORDTABLE and reset it to empty.
+ */
+void wordtable_clean(WORDTABLE *table);
+
+/*
+ * Same as process_words(), but count every distinct keyword in a
+ * WORDTABLE in expected O(1) per token, without the MAX_WORDS limit.
+ * The dictionary is compiled once with stopwords_compile().
+ *
+ * @param fp - FILE pointer to the input text file.
+ * @param table - an initialized WORDTABLE that receives the keywords.
+ * @param dictionary - the stop-word dictionary.
+ * @return - a WORDSTATS structure; keyword_count is table->size.
+ */
+WORDSTATS process_words_table(FILE *fp, WORDTABLE *table, char *dictionary);
+
+/*
+ * Same as process_words_table() with a compiled stop-word set.
+ *
+ * @param fp - FILE pointer to the input text file.
+ * @param table - an initialized WORDTABLE that receives the keywords.
+ * @param stopwords - the compiled stop-word set.
+ * @return - a WORDSTATS structure; keyword_count is table->size.
+ */
+WORDSTATS process_words_stopwords(FILE *fp, WORDTABLE *table, STOPWORDS *stopwords);
+
+/*
+ * Same statistics as process_words_stopwords() from a memory-mapped file.
+ * The file is split into nthreads chunks at newline boundaries; each chunk
+ * is tokenized on its own thread into a thread-local WORDTABLE, and the
+ * tables are merged in chunk order, so keywords keep their first-seen order.
+ * Lines of any length count as one line.
+ *
+ * @param filename - name of the input text file.
+ * @param table - an initialized WORDTABLE that receives the keywords.
+ * @param stopwords - the compiled stop-word set.
+ * @param nthreads - number of threads, at least 1.
+ * @return - a WORDSTATS structure; keyword_count is table->size.
+ */
+WORDSTATS process_words_mmap(char *filename, WORDTABLE *table, STOPWORDS *stopwords, int nthreads);
+
+/*
+ * Initialize an empty n-gram counter.
+ *
+ * @param ngrams - the counter.
+ * @param n - tokens per n-gram, 1..NGRAM_MAX.
+ * @param capacity - maximum number of n-grams kept, 0 for exact counting.
+ */
+void ngrams_init(NGRAMS *ngrams, int n, int capacity);
+
+/*
+ * Count one occurrence of the n-gram of ids[0..n-1].
+ */
+void ngrams_add(NGRAMS *ngrams, int *ids);
+
+/*
+ * Extract the k most frequent n-grams, by descending count.
+ *
+ * @param ngrams - the counter.
+ * @param top - NGRAM array of length k to receive the n-grams.
+ * @param k - the number of n-grams wanted.
+ * @return - the number of n-grams stored in top, min(k, size).
+ */
+int ngram_top(NGRAMS *ngrams, NGRAM *top, int k);
+
+/*
+ * Free the memory of an n-gram counter.
+ */
+void ngrams_clean(NGRAMS *ngrams);
+
+/*
+ * Same as process_words_table(), and also count the n-grams of consecutive
+ * keywords of each line, i.e. the token stream after stop-word filtering.
+ * Keyword IDs are their positions in table->words, so an n-gram is printed
+ * from table->words[id[i]].word.
+ *
+ * @param fp - FILE pointer to the input text file.
+ * @param table - an initialized WORDTABLE that receives the keywords.
+ * @param ngrams - an initialized NGRAMS that receives the n-grams.
+ * @param dictionary - the stop-word dictionary from create_dictionary().
+ * @return - a WORDSTATS structure; keyword_count is table->size.
+ */
+WORDSTATS process_ngrams(FILE *fp, WORDTABLE *table, NGRAMS *ngrams, char *dictionary);
+
 #endif /* MYWORD_H */
@@ -8,7 +8,10 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include "myword.h"
 
 #define DICTIONARY_SIZE 2000
@@ -77,9 +80,347 @@ void test_process_words() {
 	printf("\n");
 }
 
+void test_wordtable() {
+	printf("------------------\n");
+	printf("Test: process_words_table, wordtable_find, wordtable_top\n\n");
+
+	FILE *fp = fopen(dictionaary_filename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	char dictionary[DICTIONARY_SIZE] = { 0 };
+	create_dictionary(fp, dictionary);
+	fclose(fp);
+
+	fp = fopen(testdata_filename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	WORDTABLE table;
+	wordtable_init(&table, 0);
+	WORDSTATS ws = process_words_table(fp, &table, dictionary);
+	fclose(fp);
+
+	printf(statsformat, "line_count", ws.line_count);
+	printf(statsformat, "word_count", ws.word_count);
+	printf(statsformat, "keyword_count", ws.keyword_count);
+	int count = sizeof(word_tests) / sizeof *word_tests;
+	for (int i = 0; i < count; i++) {
+		WORD *w = wordtable_find(&table, word_tests[i]);
+		printf("wordtable_find(%s): %d\n", word_tests[i], w ? w->count : 0);
+	}
+	WORD top[3];
+	int k = wordtable_top(&table, top, 3);
+	for (int i = 0; i < k; i++) {
+		printf("top %d: %s %d\n", i + 1, top[i].word, top[i].count);
+	}
+	wordtable_clean(&table);
+	printf("\n");
+}
+
+void test_stopwords() {
+	printf("------------------\n");
+	printf("Test: stopwords_load, stopwords_contain\n\n");
+
+	FILE *fp = fopen(dictionaary_filename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	STOPWORDS stopwords;
+	int wc = stopwords_load(fp, &stopwords);
+	printf("stopwords_load(): %d\n", wc);
+
+	// every word of the file must be found
+	rewind(fp);
+	char word[64];
+	int found = 0, total = 0;
+	while (fscanf(fp, "%63[^,\n]%*[,\n]", word) == 1) {
+		total++;
+		found += stopwords_contain(&stopwords, word);
+	}
+	fclose(fp);
+	printf("contained: %d of %d\n", found, total);
+	int count = sizeof(word_tests) / sizeof *word_tests;
+	for (int i = 0; i < count; i++) {
+		printf("stopwords_contain(%s): %d\n", word_tests[i],
+				stopwords_contain(&stopwords, word_tests[i]));
+	}
+	stopwords_clean(&stopwords);
+	printf("\n");
+}
+
+void test_process_words_mmap() {
+	printf("------------------\n");
+	printf("Test: process_words_mmap\n\n");
+
+	FILE *fp = fopen(dictionaary_filename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	char dictionary[DICTIONARY_SIZE] = { 0 };
+	create_dictionary(fp, dictionary);
+	fclose(fp);
+	STOPWORDS stopwords;
+	stopwords_compile(dictionary, &stopwords);
+
+	for (int nthreads = 1; nthreads <= 3; nthreads += 2) {
+		WORDTABLE table;
+		wordtable_init(&table, 0);
+		WORDSTATS ws = process_words_mmap(testdata_filename, &table, &stopwords, nthreads);
+		printf("nthreads: %d\n", nthreads);
+		printf(statsformat, "line_count", ws.line_count);
+		printf(statsformat, "word_count", ws.word_count);
+		printf(statsformat, "keyword_count", ws.keyword_count);
+		for (int i = 0; i < table.size; i++) {
+			printf(statsformat, table.words[i].word, table.words[i].count);
+		}
+		wordtable_clean(&table);
+	}
+	stopwords_clean(&stopwords);
+	printf("\n");
+}
+
+void print_ngram(WORDTABLE *table, NGRAM *g, int n) {
+	for (int i = 0; i < n; i++) {
+		printf("%s%s", i ? " " : "", table->words[g->id[i]].word);
+	}
+}
+
+void test_ngrams() {
+	printf("------------------\n");
+	printf("Test: process_ngrams, ngram_top\n\n");
+
+	FILE *fp = fopen(dictionaary_filename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	char dictionary[DICTIONARY_SIZE] = { 0 };
+	create_dictionary(fp, dictionary);
+	fclose(fp);
+
+	for (int n = 2; n <= 3; n++) {
+		for (int capacity = 0; capacity <= 2; capacity += 2) {
+			fp = fopen(testdata_filename, "r");
+			if (fp == NULL) {
+				perror("open input file error");
+				return;
+			}
+			WORDTABLE table;
+			NGRAMS ngrams;
+			wordtable_init(&table, 0);
+			ngrams_init(&ngrams, n, capacity);
+			process_ngrams(fp, &table, &ngrams, dictionary);
+			fclose(fp);
+			NGRAM top[3];
+			int k = ngram_top(&ngrams, top, 3);
+			printf("n: %d, capacity: %d, n-grams: %d\n", n, capacity, ngrams.size);
+			for (int i = 0; i < k; i++) {
+				print_ngram(&table, &top[i], n);
+				printf(": %d (error %d)\n", top[i].count, top[i].error);
+			}
+			ngrams_clean(&ngrams);
+			wordtable_clean(&table);
+		}
+	}
+	printf("\n");
+}
+
+/*
+ * The former linear scan keyword counter, as a baseline for timing.
+ */
+int linear_count(FILE *fp, WORD *words, char *dictionary) {
+	char line[MAX_LINE_LEN];
+	int n = 0;
+	while (fgets(line, sizeof(line), fp)) {
+		char *token = strtok(line, " ,.\t\n");
+		while (token != NULL) {
+			if (!contain_word(dictionary, token)) {
+				int i = 0;
+				while (i < n && strcmp(words[i].word, token) != 0)
+					i++;
+				if (i < n)
+					words[i].count++;
+				else if (n < MAX_WORDS) {
+					strncpy(words[n].word, token, MAX_WORD_LEN - 1);
+					words[n].word[MAX_WORD_LEN - 1] = '\0';
+					words[n++].count = 1;
+				}
+			}
+			token = strtok(NULL, " ,.\t\n");
+		}
+	}
+	return n;
+}
+
+double wall_time() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Write ntokens words drawn with a skewed distribution from a vocabulary
+ * of vocab words to a new temporary file, 10 words per line; filename is
+ * a mkstemp() template that receives the file name.
+ */
+FILE *make_corpus(int ntokens, int vocab, char *filename) {
+	int fd = mkstemp(filename);
+	FILE *fp = (fd < 0) ? NULL : fdopen(fd, "w+");
+	if (fp == NULL)
+		return NULL;
+	for (int i = 0; i < ntokens; i++) {
+		double u = (double) rand() / RAND_MAX;
+		int id = (int) (u * u * u * (vocab - 1));
+		char word[8];
+		int len = 0;
+		do {
+			word[len++] = 'a' + id % 26;
+			id /= 26;
+		} while (id > 0);
+		word[len] = '\0';
+		fprintf(fp, "%s%c", word, (i % 10 == 9) ? '\n' : ' ');
+	}
+	return fp;
+}
+
+void time_test_process_words(int ntokens) {
+	printf("------------------\n");
+	printf("Test: runtime, %d tokens\n\n", ntokens);
+	char dictionary[] = " the a of ";
+	int vocab = 100000;
+	char filename[] = "/tmp/myword_XXXXXX";
+	FILE *fp = make_corpus(ntokens, vocab, filename);
+	if (fp == NULL) {
+		perror("temporary file error");
+		return;
+	}
+	fflush(fp);
+
+	rewind(fp);
+	WORDTABLE table;
+	wordtable_init(&table, 0);
+	clock_t t1 = clock();
+	WORDSTATS ws = process_words_table(fp, &table, dictionary);
+	double s = (double) (clock() - t1) / CLOCKS_PER_SEC;
+	printf("hash table:  %0.3f (s), %0.2f M tokens/s, keywords: %d\n", s,
+			ws.word_count / (s > 0 ? s : 1e-6) / 1e6, ws.keyword_count);
+
+	// mmap pipeline; wall time, as clock() adds up all threads
+	STOPWORDS stopwords;
+	stopwords_compile(dictionary, &stopwords);
+	for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+		WORDTABLE mtable;
+		wordtable_init(&mtable, 0);
+		double w1 = wall_time();
+		WORDSTATS ms = process_words_mmap(filename, &mtable, &stopwords, nthreads);
+		double w = wall_time() - w1;
+		int same = ms.line_count == ws.line_count && ms.word_count == ws.word_count
+				&& ms.keyword_count == ws.keyword_count;
+		for (int i = 0; same && i < mtable.size; i++) {
+			same = strcmp(mtable.words[i].word, table.words[i].word) == 0
+					&& mtable.words[i].count == table.words[i].count;
+		}
+		printf("mmap %d thread(s): %0.3f (s), %0.2f M tokens/s, same stats: %d\n", nthreads, w,
+				ms.word_count / (w > 0 ? w : 1e-6) / 1e6, same);
+		wordtable_clean(&mtable);
+	}
+	stopwords_clean(&stopwords);
+
+	if (ntokens <= 200000) {
+		rewind(fp);
+		WORD *words = malloc(MAX_WORDS * sizeof(WORD));
+		t1 = clock();
+		int n = linear_count(fp, words, dictionary);
+		s = (double) (clock() - t1) / CLOCKS_PER_SEC;
+		printf("linear scan: %0.3f (s), %0.2f M tokens/s, keywords: %d (capped)\n", s,
+				ws.word_count / (s > 0 ? s : 1e-6) / 1e6, n);
+		free(words);
+	}
+
+	// stop-word lookups: dictionary string scan against the compiled set
+	FILE *dfp = fopen(dictionaary_filename, "r");
+	if (dfp != NULL) {
+		STOPWORDS stopwords;
+		int n = stopwords_load(dfp, &stopwords);
+		fclose(dfp);
+		int len = 1;
+		for (int i = 0; i < n; i++)
+			len += strlen(stopwords.pool + stopwords.offset[i]) + 2;
+		char *dict = malloc(len), *d = dict;
+		for (int i = 0; i < n; i++)
+			d += sprintf(d, " %s ", stopwords.pool + stopwords.offset[i]);
+		char *words[256];   // half stop words, half keywords
+		for (int i = 0; i < 128; i++) {
+			words[i] = stopwords.pool + stopwords.offset[i % n];
+			words[128 + i] = table.words[i % table.size].word;
+		}
+		int lookups = 1000000, hits = 0;
+		t1 = clock();
+		for (int i = 0; i < lookups; i++)
+			hits += contain_word(dict, words[i & 255]);
+		s = (double) (clock() - t1) / CLOCKS_PER_SEC;
+		printf("contain_word:      %0.2f M lookups/s, hits: %d\n", lookups / (s > 0 ? s : 1e-6) / 1e6, hits);
+		hits = 0;
+		t1 = clock();
+		for (int i = 0; i < lookups; i++)
+			hits += stopwords_contain(&stopwords, words[i & 255]);
+		s = (double) (clock() - t1) / CLOCKS_PER_SEC;
+		printf("stopwords_contain: %0.2f M lookups/s, hits: %d\n", lookups / (s > 0 ? s : 1e-6) / 1e6, hits);
+		free(dict);
+		stopwords_clean(&stopwords);
+	}
+
+	// bigrams, exact and space-saving with 100000 entries
+	for (int capacity = 0; capacity <= 100000; capacity += 100000) {
+		rewind(fp);
+		WORDTABLE gtable;
+		NGRAMS ngrams;
+		wordtable_init(&gtable, 0);
+		ngrams_init(&ngrams, 2, capacity);
+		t1 = clock();
+		process_ngrams(fp, &gtable, &ngrams, dictionary);
+		s = (double) (clock() - t1) / CLOCKS_PER_SEC;
+		NGRAM gtop[3];
+		int k = ngram_top(&ngrams, gtop, 3);
+		printf("bigrams, capacity %6d: %0.3f (s), %0.2f M tokens/s, kept: %d, top:", capacity, s,
+				ws.word_count / (s > 0 ? s : 1e-6) / 1e6, ngrams.size);
+		for (int i = 0; i < k; i++) {
+			printf(" [");
+			print_ngram(&gtable, &gtop[i], 2);
+			printf("] %d (error %d)", gtop[i].count, gtop[i].error);
+		}
+		printf("\n");
+		ngrams_clean(&ngrams);
+		wordtable_clean(&gtable);
+	}
+
+	WORD top[5];
+	int k = wordtable_top(&table, top, 5);
+	for (int i = 0; i < k; i++) {
+		printf("top %d: %s %d\n", i + 1, top[i].word, top[i].count);
+	}
+	wordtable_clean(&table);
+	fclose(fp);
+	remove(filename);
+	printf("\n");
+}
+
 int main(int argc, char *args[]) {
+	if (argc > 1) {
+		time_test_process_words(atoi(args[1]));
+		return 0;
+	}
 	test_dictionary();
 	test_process_words();
+	test_wordtable();
+	test_stopwords();
+	test_process_words_mmap();
+	test_ngrams();
 	return 0;
 }
 
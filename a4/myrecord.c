@@ -4,6 +4,23 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdio.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// prefault the mapping in one call where the system supports it
+#ifdef MAP_POPULATE
+#define IMPORT_MAP_FLAGS MAP_POPULATE
+#else
+#define IMPORT_MAP_FLAGS 0
+#endif
 
 /* 
  * Convert a percentage score into a letter grade.
@@ -79,25 +96,474 @@ int import_data(FILE *fp, RECORD *dataset) {
     return count;
 }
 
+void recordset_init(RECORDSET *rs, RECORD *buffer, int capacity) {
+    rs->records = buffer;
+    rs->capacity = (buffer != NULL && capacity > 0) ? capacity : 0;
+    rs->growable = (buffer == NULL);
+    rs->count = 0;
+    rs->total = 0;
+    rs->malformed = 0;
+    rs->first_malformed = 0;
+}
+
+void recordset_clean(RECORDSET *rs) {
+    if (rs->growable)
+        free(rs->records);
+    recordset_init(rs, NULL, 0);
+}
+
 /*
- * Comparison function for sorting RECORD pointers in ascending order (by score).
- * This function is used by the generic sort routine (my_sort) in process_data.
+ * Make room for one more record; returns 0 if a caller buffer is full.
  */
-static int compare_record_asc(void *p1, void *p2) {
-    RECORD *r1 = *(RECORD **)p1;
-    RECORD *r2 = *(RECORD **)p2;
-    
-    if (r1->score < r2->score)
-        return -1;
-    else if (r1->score > r2->score)
+static int recordset_room(RECORDSET *rs) {
+    if (rs->count < rs->capacity)
         return 1;
-    else
+    if (!rs->growable)
+        return 0;
+    int capacity = rs->capacity < 1024 ? 1024 : 2 * rs->capacity;
+    RECORD *records = (RECORD *)realloc(rs->records, capacity * sizeof(RECORD));
+    if (records == NULL) {
+        fprintf(stderr, "Memory allocation failed in import_records()\n");
+        exit(EXIT_FAILURE);
+    }
+    rs->records = records;
+    rs->capacity = capacity;
+    return 1;
+}
+
+static const double pow10_table[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*
+ * Parse a decimal number in [p, end) into *value, as atof() would followed
+ * by the conversion to float. Up to 19 significant digits and a power of
+ * ten within 10^22 take the exact path: both the integer and the power are
+ * exact doubles, so one multiplication or division rounds correctly.
+ * Other numbers go to strtod() on a bounded copy.
+ * @return - the end of the number, or NULL if there is none.
+ */
+static const char *parse_score(const char *p, const char *end, float *value) {
+    const char *start = p;
+    int negative = 0;
+    if (p < end && (*p == '+' || *p == '-'))
+        negative = (*p++ == '-');
+    unsigned long long mantissa = 0;
+    int digits = 0, exp10 = 0, any = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, any = 1) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            digits += (mantissa != 0);
+        } else {
+            exp10++;
+            digits++;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, any = 1) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits += (mantissa != 0);
+                exp10--;
+            } else {
+                digits++;
+            }
+        }
+    }
+    if (!any)
+        return NULL;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        int esign = 1, e = 0, edigits = 0;
+        if (q < end && (*q == '+' || *q == '-'))
+            esign = (*q++ == '-') ? -1 : 1;
+        for (; q < end && *q >= '0' && *q <= '9'; q++, edigits++) {
+            if (e < 10000)
+                e = e * 10 + (*q - '0');
+        }
+        if (edigits > 0) {
+            exp10 += esign * e;
+            p = q;
+        }
+    }
+
+    double d;
+    if (digits <= 19 && mantissa < (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+        d = (double)mantissa;
+        d = (exp10 < 0) ? d / pow10_table[-exp10] : d * pow10_table[exp10];
+    } else {
+        char buf[128];
+        int len = p - start;
+        if (len >= (int)sizeof buf)
+            len = sizeof buf - 1;
+        memcpy(buf, start, len);
+        buf[len] = '\0';
+        d = strtod(buf, NULL);
+        *value = (float)d;
+        return p;
+    }
+    *value = (float)(negative ? -d : d);
+    return p;
+}
+
+/*
+ * Parse one line [p, end) without its newline.
+ * @return - 1 for a record, 0 for a blank line, -1 for a malformed line.
+ */
+static int parse_record(const char *p, const char *end, RECORD *r) {
+    if (end > p && end[-1] == '\r')
+        end--;
+    const char *q = p;
+    while (q < end && (*q == ' ' || *q == '\t'))
+        q++;
+    if (q == end)
         return 0;
+    const char *comma = memchr(p, ',', end - p);
+    if (comma == NULL || comma == p)
+        return -1;
+    int len = comma - p;
+    if (len > 20)
+        len = 20;
+    memcpy(r->name, p, len);
+    r->name[len] = '\0';
+
+    q = comma + 1;
+    while (q < end && (*q == ' ' || *q == '\t'))
+        q++;
+    q = parse_score(q, end, &r->score);
+    if (q == NULL)
+        return -1;
+    while (q < end && (*q == ' ' || *q == '\t'))
+        q++;
+    return (q == end) ? 1 : -1;
+}
+
+/*
+ * Single pass over a well-formed line "name,score" starting at p.
+ * @return - the end of the line, or NULL to let parse_record() decide.
+ */
+static const char *parse_line(const char *p, const char *end, RECORD *r) {
+    const char *comma = memchr(p, ',', (end - p < 64) ? end - p : 64);
+    if (comma == NULL || comma == p || memchr(p, '\n', comma - p) != NULL)
+        return NULL;
+    const char *q = comma + 1;
+    while (q < end && (*q == ' ' || *q == '\t'))
+        q++;
+    q = parse_score(q, end, &r->score);
+    if (q == NULL)
+        return NULL;
+    while (q < end && (*q == ' ' || *q == '\t'))
+        q++;
+    if (q < end && *q == '\r')
+        q++;
+    if (q < end && *q != '\n')
+        return NULL;
+    int len = comma - p;
+    if (len > 20)
+        len = 20;
+    memcpy(r->name, p, len);
+    r->name[len] = '\0';
+    return q;
+}
+
+/*
+ * One chunk of the mapped file: its lines are parsed into rs, at most limit
+ * of them stored, and the first malformed lines are remembered by their
+ * local line number and text.
+ */
+typedef struct {
+    const char *start, *end;
+    RECORDSET *rs;
+    int limit;
+    int lines;
+    int reports;
+    int report_line[IMPORT_MAX_REPORTS];
+    const char *report_text[IMPORT_MAX_REPORTS];
+    int report_len[IMPORT_MAX_REPORTS];
+} IMPORTCHUNK;
+
+static void *import_chunk(void *arg) {
+    IMPORTCHUNK *chunk = (IMPORTCHUNK *)arg;
+    RECORDSET *rs = chunk->rs;
+    const char *p = chunk->start, *end = chunk->end;
+    RECORD r;
+    while (p < end) {
+        const char *eol = parse_line(p, end, &r);
+        int status = 1;
+        if (eol == NULL) {
+            const char *nl = memchr(p, '\n', end - p);
+            eol = (nl != NULL) ? nl : end;
+            status = parse_record(p, eol, &r);
+        }
+        chunk->lines++;
+        if (status > 0) {
+            rs->total++;
+            if (rs->count < chunk->limit && recordset_room(rs))
+                rs->records[rs->count++] = r;
+        } else if (status < 0) {
+            if (rs->malformed++ == 0)
+                rs->first_malformed = chunk->lines;
+            if (chunk->reports < IMPORT_MAX_REPORTS) {
+                chunk->report_line[chunk->reports] = chunk->lines;
+                chunk->report_text[chunk->reports] = p;
+                chunk->report_len[chunk->reports++] = eol - p;
+            }
+        }
+        p = eol + 1;
+    }
+    return NULL;
+}
+
+/*
+ * Map the file, cut it into nthreads chunks at newlines and parse them;
+ * chunk 0 is parsed into rs directly on the calling thread, the others
+ * into their own growable sets that are appended afterwards in order.
+ * With a caller buffer no chunk stores more than the room left in it, the
+ * records past that are only counted.
+ */
+int import_records(char *filename, RECORDSET *rs, int nthreads) {
+    if (filename == NULL || rs == NULL)
+        return -1;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("open input file error");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return rs->count;
+    }
+    char *data = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE | IMPORT_MAP_FLAGS, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap input file error");
+        return -1;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    if (nthreads < 1)
+        nthreads = 1;
+    if ((size_t)nthreads > size / 4096 + 1)
+        nthreads = size / 4096 + 1;
+    IMPORTCHUNK *chunks = (IMPORTCHUNK *)calloc(nthreads, sizeof(IMPORTCHUNK));
+    RECORDSET *sets = (RECORDSET *)calloc(nthreads, sizeof(RECORDSET));
+    pthread_t *threads = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+    if (chunks == NULL || sets == NULL || threads == NULL) {
+        fprintf(stderr, "Memory allocation failed in import_records()\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // a growable set starts at about one record per 16 bytes of file
+    if (rs->growable && rs->capacity == 0 && nthreads == 1) {
+        size_t estimate = size / 16 + 1;
+        size_t limit = (1u << 30) / sizeof(RECORD);
+        rs->capacity = (estimate < limit) ? estimate : limit;
+        rs->records = (RECORD *)malloc(rs->capacity * sizeof(RECORD));
+        if (rs->records == NULL) {
+            fprintf(stderr, "Memory allocation failed in import_records()\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    const char *start = data, *end = data + size;
+    for (int i = 0; i < nthreads; i++) {
+        const char *cut = (i == nthreads - 1) ? end : data + size / nthreads * (i + 1);
+        if (cut < start)
+            cut = start;
+        if (cut < end) {
+            const char *nl = memchr(cut, '\n', end - cut);
+            cut = (nl != NULL) ? nl + 1 : end;
+        }
+        chunks[i].start = start;
+        chunks[i].end = cut;
+        chunks[i].limit = INT_MAX;
+        if (i == 0) {
+            chunks[i].rs = rs;
+        } else {
+            if (!rs->growable)
+                chunks[i].limit = rs->capacity - rs->count;
+            recordset_init(&sets[i], NULL, 0);
+            chunks[i].rs = &sets[i];
+        }
+        start = cut;
+    }
+
+    int started = 1;
+    while (started < nthreads
+            && pthread_create(&threads[started], NULL, import_chunk, &chunks[started]) == 0)
+        started++;
+    for (int i = started; i < nthreads; i++)
+        import_chunk(&chunks[i]);
+    import_chunk(&chunks[0]);
+    for (int i = 1; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    // append in order and number the malformed lines of the whole file
+    int line = 0, reported = 0;
+    for (int i = 0; i < nthreads; i++) {
+        if (i > 0) {
+            RECORDSET *cs = &sets[i];
+            for (int j = 0; j < cs->count && recordset_room(rs); j++)
+                rs->records[rs->count++] = cs->records[j];
+            rs->total += cs->total;
+            if (cs->malformed > 0 && rs->first_malformed == 0)
+                rs->first_malformed = line + cs->first_malformed;
+            rs->malformed += cs->malformed;
+            recordset_clean(cs);
+        }
+        for (int j = 0; j < chunks[i].reports && reported < IMPORT_MAX_REPORTS; j++, reported++) {
+            int len = chunks[i].report_len[j] > 60 ? 60 : chunks[i].report_len[j];
+            fprintf(stderr, "%s:%d: malformed record: %.*s\n", filename,
+                    line + chunks[i].report_line[j], len, chunks[i].report_text[j]);
+        }
+        line += chunks[i].lines;
+    }
+
+    free(chunks);
+    free(sets);
+    free(threads);
+    munmap(data, size);
+    return rs->count;
+}
+
+static void swap_score(float *a, int i, int j) {
+    float t = a[i];
+    a[i] = a[j];
+    a[j] = t;
+}
+
+/*
+ * Sift a[i] down in the max-heap a[left..left+n-1].
+ */
+static void sift_score(float *a, int left, int n, int i) {
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= n)
+            return;
+        if (c + 1 < n && a[left + c + 1] > a[left + c])
+            c++;
+        if (!(a[left + c] > a[left + i]))
+            return;
+        swap_score(a, left + i, left + c);
+        i = c;
+    }
+}
+
+/*
+ * Heapsort a[left..right], the fallback that bounds selection by O(n log n).
+ */
+static void heap_sort_scores(float *a, int left, int right) {
+    int n = right - left + 1;
+    for (int i = n / 2 - 1; i >= 0; i--)
+        sift_score(a, left, n, i);
+    for (int m = n - 1; m > 0; m--) {
+        swap_score(a, left, left + m);
+        sift_score(a, left, m, 0);
+    }
+}
+
+/*
+ * Floyd-Rivest selection: rearrange a[left..right] so that a[k] is the
+ * value of rank k, with no larger value before it and no smaller value after
+ * it. Large ranges are first narrowed by recursing on a sample around k,
+ * giving expected n + min(k, n - k) + o(n) comparisons; a range that does
+ * not shrink within about 2 log2(n) rounds is heapsorted instead.
+ */
+static void select_score(float *a, int left, int right, int k) {
+    int budget = 2 * (int)log2(right - left + 2);
+    while (right > left) {
+        if (budget-- < 0) {
+            heap_sort_scores(a, left, right);
+            return;
+        }
+        if (right - left > 600) {
+            double n = right - left + 1;
+            double i = k - left + 1;
+            double z = log(n);
+            double s = 0.5 * exp(2 * z / 3);
+            double sd = 0.5 * sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+            int l = (int)fmax(left, k - i * s / n + sd);
+            int r = (int)fmin(right, k + (n - i) * s / n + sd);
+            select_score(a, l, r, k);
+        }
+        float t = a[k];
+        int i = left, j = right;
+        swap_score(a, left, k);
+        if (a[right] > t)
+            swap_score(a, right, left);
+        while (i < j) {
+            swap_score(a, i, j);
+            i++;
+            j--;
+            while (a[i] < t)
+                i++;
+            while (a[j] > t)
+                j--;
+        }
+        if (a[left] == t) {
+            swap_score(a, left, j);
+        } else {
+            j++;
+            swap_score(a, j, right);
+        }
+        if (j <= k)
+            left = j + 1;
+        if (k <= j)
+            right = j - 1;
+    }
+}
+
+/*
+ * The value a fraction frac of the way from the score of one rank to the next.
+ */
+static float interpolate_rank(float low, float high, double frac) {
+    return (float)(low + frac * ((double)high - low));
+}
+
+/*
+ * Quantiles of the n scores in a, which is rearranged. The ranks are
+ * selected in increasing order, each one only searching the part of the
+ * array after the previous rank.
+ */
+static void score_quantiles(float *a, int n, const float *q, float *values, int m) {
+    int *order = (int *)malloc(m * sizeof(int));
+    if (order == NULL) {
+        fprintf(stderr, "Memory allocation failed in quantiles()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < m; i++) {
+        int j = i;
+        for (; j > 0 && q[order[j - 1]] > q[i]; j--)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+    int done = -1;   // highest rank selected so far
+    for (int o = 0; o < m; o++) {
+        int i = order[o];
+        double h = (q[i] < 0 ? 0 : q[i] > 1 ? 1 : q[i]) * (n - 1);
+        int k = (int)h;
+        int top = (k + 1 < n) ? k + 1 : k;
+        for (int r = k; r <= top; r++) {
+            if (r > done) {
+                select_score(a, done + 1, n - 1, r);
+                done = r;
+            }
+        }
+        values[i] = interpolate_rank(a[k], a[top], h - k);
+    }
+    free(order);
 }
 
 /*
  * Process the record data: compute the count, mean, standard deviation, and median.
- * The median is computed by sorting a copy (via an array of pointers) of the dataset.
+ * The mean and variance are accumulated by Welford's method in double in the
+ * same pass that copies the scores, and the median is selected from the copy.
  */
 STATS process_data(RECORD *dataset, int count) {
     STATS stats;
@@ -108,86 +574,230 @@ STATS process_data(RECORD *dataset, int count) {
         return stats;
     }
     
-    /* Compute mean */
-    float sum = 0;
+    float *scores = (float *)malloc(count * sizeof(float));
+    double mean = 0, m2 = 0;
     for (int i = 0; i < count; i++) {
-        sum += dataset[i].score;
+        double x = dataset[i].score;
+        double d = x - mean;
+        mean += d / (i + 1);
+        m2 += d * (x - mean);
+        if (scores != NULL)
+            scores[i] = dataset[i].score;
     }
-    stats.mean = sum / count;
+    stats.mean = mean;
+    stats.stddev = sqrt(m2 / count);
     
-    /* Compute standard deviation */
-    float sum_sq_diff = 0;
-    for (int i = 0; i < count; i++) {
-        float diff = dataset[i].score - stats.mean;
-        sum_sq_diff += diff * diff;
-    }
-    stats.stddev = sqrt(sum_sq_diff / count);
-    
-    /* To compute median, sort an array of pointers to records in ascending order */
-    RECORD **records_ptr = (RECORD **)malloc(count * sizeof(RECORD *));
-    if (records_ptr == NULL) {
+    if (scores == NULL) {
         stats.median = 0;
         return stats;
     }
-    for (int i = 0; i < count; i++) {
-        records_ptr[i] = &dataset[i];
-    }
-    
-    /* Use the generic sort function (e.g., quick sort) to sort the pointers in ascending order */
-    my_sort((void **)records_ptr, 0, count - 1, compare_record_asc);
-    
-    if (count % 2 == 1) {
-        /* Odd number: median is the middle score */
-        stats.median = records_ptr[count / 2]->score;
-    } else {
-        /* Even number: median is the average of the two middle scores */
-        stats.median = (records_ptr[(count / 2) - 1]->score + records_ptr[count / 2]->score) / 2.0;
-    }
-    
-    free(records_ptr);
+    float half = 0.5;
+    score_quantiles(scores, count, &half, &stats.median, 1);
+    free(scores);
     
     return stats;
 }
 
 /*
- * Comparison function for sorting RECORD pointers in descending order (by score).
- * This is used in report_data so that records are printed from highest to lowest score.
+ * Compute quantiles of the scores by selection on a copy of them.
  */
-static int compare_record_desc(void *p1, void *p2) {
-    RECORD *r1 = *(RECORD **)p1;
-    RECORD *r2 = *(RECORD **)p2;
-    
-    if (r1->score > r2->score)
-        return -1;
-    else if (r1->score < r2->score)
-        return 1;
-    else
+int quantiles(RECORD *dataset, int count, const float *q, float *values, int m) {
+    if (dataset == NULL || count <= 0 || q == NULL || values == NULL || m <= 0)
+        return 0;
+    float *scores = (float *)malloc(count * sizeof(float));
+    if (scores == NULL)
         return 0;
+    for (int i = 0; i < count; i++)
+        scores[i] = dataset[i].score;
+    score_quantiles(scores, count, q, values, m);
+    free(scores);
+    return m;
 }
 
 /*
- * Prepare and write the report to the output file.
- * The report includes the computed statistics and a list of records (sorted in descending order)
- * with their corresponding letter grades.
+ * Quick sort of centroids by mean, with insertion sort for short ranges.
  */
-int report_data(FILE *fp, RECORD *dataset, STATS stats) {
-    if (fp == NULL || dataset == NULL || stats.count < 1)
-        return 0;
-    
-    int count = stats.count;
-    
-    /* Create an array of pointers to records for sorting in descending order */
-    RECORD **records_ptr = (RECORD **)malloc(count * sizeof(RECORD *));
-    if (records_ptr == NULL)
+static void sort_centroids(CENTROID *c, int n) {
+    while (n > 16) {
+        int mid = n / 2;
+        CENTROID t;
+        if (c[mid].mean < c[0].mean) { t = c[mid]; c[mid] = c[0]; c[0] = t; }
+        if (c[n - 1].mean < c[0].mean) { t = c[n - 1]; c[n - 1] = c[0]; c[0] = t; }
+        if (c[n - 1].mean < c[mid].mean) { t = c[n - 1]; c[n - 1] = c[mid]; c[mid] = t; }
+        double pivot = c[mid].mean;
+        int i = 0, j = n - 1;
+        while (i <= j) {
+            while (c[i].mean < pivot)
+                i++;
+            while (c[j].mean > pivot)
+                j--;
+            if (i <= j) {
+                t = c[i]; c[i] = c[j]; c[j] = t;
+                i++;
+                j--;
+            }
+        }
+        // recurse on the smaller side, loop on the larger one
+        if (j + 1 < n - i) {
+            sort_centroids(c, j + 1);
+            c += i;
+            n -= i;
+        } else {
+            sort_centroids(c + i, n - i);
+            n = j + 1;
+        }
+    }
+    for (int i = 1; i < n; i++) {
+        CENTROID t = c[i];
+        int j = i;
+        for (; j > 0 && c[j - 1].mean > t.mean; j--)
+            c[j] = c[j - 1];
+        c[j] = t;
+    }
+}
+
+void tdigest_init(TDIGEST *td, double compression) {
+    td->compression = (compression > 0) ? compression : TDIGEST_COMPRESSION;
+    // about compression centroids at most and a buffer ten times that,
+    // followed by as much scratch space for merging
+    td->capacity = 11 * (int)td->compression + 10;
+    td->centroids = (CENTROID *)malloc(2 * td->capacity * sizeof(CENTROID));
+    if (td->centroids == NULL) {
+        fprintf(stderr, "Memory allocation failed in tdigest_init()\n");
+        exit(EXIT_FAILURE);
+    }
+    td->merged = 0;
+    td->buffered = 0;
+    td->weight = 0;
+    td->min = td->max = 0;
+}
+
+void tdigest_clean(TDIGEST *td) {
+    free(td->centroids);
+    td->centroids = NULL;
+    td->merged = td->buffered = td->capacity = 0;
+    td->weight = 0;
+}
+
+/*
+ * Merge the buffered values into the centroids: sort the buffer, merge it
+ * with the centroids by mean and sweep once, growing the current centroid while it spans at most one unit
+ * of the scale k(q) = compression / (2 pi) * asin(2q - 1), which keeps
+ * centroids near q = 0 and q = 1 small.
+ */
+static void tdigest_merge(TDIGEST *td) {
+    if (td->buffered == 0)
+        return;
+    CENTROID *c = td->centroids, *buffer = c + td->merged, *all = c + td->capacity;
+    sort_centroids(buffer, td->buffered);
+    int i = 0, j = 0, n = 0;
+    while (i < td->merged || j < td->buffered) {
+        if (j == td->buffered || (i < td->merged && c[i].mean <= buffer[j].mean))
+            all[n++] = c[i++];
+        else
+            all[n++] = buffer[j++];
+    }
+
+    // the current centroid may grow up to q_limit, one unit of k past its start
+    double step = 2 * M_PI / td->compression;
+    double so_far = 0;   // weight before the current centroid
+    double q_limit = (sin(-M_PI / 2 + step) + 1) / 2;
+    int out = 0;
+    CENTROID cur = all[0];
+    for (i = 1; i < n; i++) {
+        if ((so_far + cur.weight + all[i].weight) / td->weight <= q_limit) {
+            cur.weight += all[i].weight;
+            cur.mean += (all[i].mean - cur.mean) * all[i].weight / cur.weight;
+        } else {
+            so_far += cur.weight;
+            c[out++] = cur;
+            double angle = asin(fmin(2 * so_far / td->weight - 1, 1)) + step;
+            q_limit = (angle >= M_PI / 2) ? 1 : (sin(angle) + 1) / 2;
+            cur = all[i];
+        }
+    }
+    c[out++] = cur;
+    td->merged = out;
+    td->buffered = 0;
+}
+
+void tdigest_add(TDIGEST *td, double value) {
+    if (td->merged + td->buffered == td->capacity)
+        tdigest_merge(td);
+    if (td->weight == 0) {
+        td->min = td->max = value;
+    } else if (value < td->min) {
+        td->min = value;
+    } else if (value > td->max) {
+        td->max = value;
+    }
+    CENTROID *c = &td->centroids[td->merged + td->buffered++];
+    c->mean = value;
+    c->weight = 1;
+    td->weight += 1;
+}
+
+/*
+ * Interpolate between centroid centres, each centroid holding its weight
+ * around its mean, and towards min and max beyond the outer centres.
+ */
+double tdigest_quantile(TDIGEST *td, double q) {
+    tdigest_merge(td);
+    if (td->merged == 0)
         return 0;
-    for (int i = 0; i < count; i++) {
-        records_ptr[i] = &dataset[i];
+    if (q <= 0)
+        return td->min;
+    if (q >= 1)
+        return td->max;
+    CENTROID *c = td->centroids;
+    int m = td->merged;
+    double index = q * td->weight;
+    double centre = c[0].weight / 2;
+    if (index < centre)
+        return td->min + (c[0].mean - td->min) * index / centre;
+    for (int i = 0; i + 1 < m; i++) {
+        double gap = (c[i].weight + c[i + 1].weight) / 2;
+        if (index < centre + gap)
+            return c[i].mean + (c[i + 1].mean - c[i].mean) * (index - centre) / gap;
+        centre += gap;
     }
-    
-    /* Sort the pointers in descending order by score */
-    my_sort((void **)records_ptr, 0, count - 1, compare_record_desc);
-    
-    /* Write the statistics header */
+    double rest = td->weight - centre;
+    return c[m - 1].mean + (td->max - c[m - 1].mean) * (index - centre) / rest;
+}
+
+/*
+ * Stream name,score lines through Welford's method and a t-digest.
+ */
+STATS process_stream(FILE *fp, TDIGEST *td) {
+    STATS stats = { 0, 0, 0, 0 };
+    if (fp == NULL || td == NULL)
+        return stats;
+    char line[256];
+    RECORD r;
+    double mean = 0, m2 = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char *eol = line + strcspn(line, "\n");
+        if (parse_record(line, eol, &r) <= 0)
+            continue;
+        double x = r.score;
+        stats.count++;
+        double d = x - mean;
+        mean += d / stats.count;
+        m2 += d * (x - mean);
+        tdigest_add(td, x);
+    }
+    if (stats.count > 0) {
+        stats.mean = mean;
+        stats.stddev = sqrt(m2 / stats.count);
+        stats.median = tdigest_quantile(td, 0.5);
+    }
+    return stats;
+}
+
+/*
+ * Write the statistics header of a report.
+ */
+static void write_report_header(FILE *fp, STATS stats) {
     fprintf(fp, "Record Count: %d\n", stats.count);
     fprintf(fp, "Mean: %.2f\n", stats.mean);
     fprintf(fp, "Standard Deviation: %.2f\n", stats.stddev);
@@ -196,13 +806,576 @@ int report_data(FILE *fp, RECORD *dataset, STATS stats) {
     fprintf(fp, "-----------------------------------------------\n");
     fprintf(fp, "%-20s %-7s %-3s\n", "Name", "Score", "Grade");
     fprintf(fp, "-----------------------------------------------\n");
+}
+
+#define REPORT_BUFFER (1 << 16)   /* bytes buffered by a report writer */
+#define REPORT_LINE_MAX 128        /* longest report line but for a long name */
+
+/*
+ * Letter grades padded to the report column width, by the integer part of
+ * the score for scores in [0, 100); all grade boundaries are integers.
+ */
+static char grade_table[100][4];
+static pthread_once_t grade_table_once = PTHREAD_ONCE_INIT;
+
+static void init_grade_table(void) {
+    for (int i = 0; i < 100; i++)
+        snprintf(grade_table[i], sizeof grade_table[i], "%-3s", grade(i).letter_grade);
+}
+
+/*
+ * Report lines are formatted into a large buffer that is written out with
+ * fwrite() when nearly full, instead of one fprintf() call per record.
+ */
+typedef struct {
+    FILE *fp;
+    int used;
+    char *buf;
+} REPORTWRITER;
+
+static void writer_init(REPORTWRITER *w, FILE *fp) {
+    w->fp = fp;
+    w->used = 0;
+    pthread_once(&grade_table_once, init_grade_table);
+    w->buf = (char *)malloc(REPORT_BUFFER);
+    if (w->buf == NULL) {
+        fprintf(stderr, "Memory allocation failed in report writer\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void writer_flush(REPORTWRITER *w) {
+    fwrite(w->buf, 1, w->used, w->fp);
+    w->used = 0;
+}
+
+static void writer_clean(REPORTWRITER *w) {
+    writer_flush(w);
+    free(w->buf);
+    w->buf = NULL;
+}
+
+/*
+ * Write score to out as printf("%.2f") does: the float times 100 is exact
+ * in a double, so its fraction decides the rounding, with ties to even as
+ * in glibc. Very large scores and non-numbers go through snprintf().
+ * @return - the number of characters written.
+ */
+static int format_score(char *out, float score) {
+    double v = score;
+    if (!(fabs(v) < 1e15))
+        return snprintf(out, REPORT_LINE_MAX / 2, "%.2f", v);
+    char *p = out;
+    if (signbit(v)) {
+        *p++ = '-';
+        v = -v;
+    }
+    double m = v * 100;
+    unsigned long long n = (unsigned long long)m;
+    double frac = m - (double)n;
+    if (frac > 0.5 || (frac == 0.5 && (n & 1)))
+        n++;
+    char digits[20];
+    int len = 0;
+    unsigned long long whole = n / 100;
+    do {
+        digits[len++] = '0' + whole % 10;
+        whole /= 10;
+    } while (whole > 0);
+    while (len > 0)
+        *p++ = digits[--len];
+    *p++ = '.';
+    *p++ = '0' + (n % 100) / 10;
+    *p++ = '0' + n % 10;
+    return p - out;
+}
+
+/*
+ * Write one record of a report with its letter grade, in the format
+ * "%-20s %-7.2f %-3s\n".
+ */
+static void write_report_record(REPORTWRITER *w, RECORD *r) {
+    int len = strlen(r->name);
+    if (REPORT_BUFFER - w->used < REPORT_LINE_MAX + len)
+        writer_flush(w);
+    char *p = w->buf + w->used;
+    memcpy(p, r->name, len);
+    p += len;
+    for (; len < 20; len++)
+        *p++ = ' ';
+    *p++ = ' ';
+    len = format_score(p, r->score);
+    p += len;
+    for (; len < 7; len++)
+        *p++ = ' ';
+    *p++ = ' ';
+    if (r->score >= 0 && r->score < 100)
+        memcpy(p, grade_table[(int)r->score], 3);
+    else
+        snprintf(p, 4, "%-3s", grade(r->score).letter_grade);
+    p += 3;
+    *p++ = '\n';
+    w->used = p - w->buf;
+}
+
+/*
+ * Sort the scores in descending order, carrying the record positions along;
+ * records with equal scores stay in input order. Returns the positions and
+ * leaves the sorted scores in *scores, or returns NULL if out of memory.
+ */
+static int *report_order(RECORD *dataset, int count, float **scores) {
+    *scores = (float *)malloc(count * sizeof(float));
+    int *order = (int *)malloc(count * sizeof(int));
+    if (*scores == NULL || order == NULL) {
+        free(*scores);
+        free(order);
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        (*scores)[i] = dataset[i].score;
+        order[i] = i;
+    }
+    sort_float_keys(*scores, order, count, 1);
+    return order;
+}
+
+/*
+ * Prepare and write the report to the output file.
+ * The report includes the computed statistics and a list of records (sorted in descending order)
+ * with their corresponding letter grades.
+ */
+int report_data(FILE *fp, RECORD *dataset, STATS stats) {
+    if (fp == NULL || dataset == NULL || stats.count < 1)
+        return 0;
+    
+    int count = stats.count;
+    float *scores;
+    int *order = report_order(dataset, count, &scores);
+    if (order == NULL)
+        return 0;
     
-    /* Write each record with its letter grade */
+    /* Write the statistics header and each record with its letter grade */
+    write_report_header(fp, stats);
+    REPORTWRITER w;
+    writer_init(&w, fp);
     for (int i = 0; i < count; i++) {
-        GRADE g = grade(records_ptr[i]->score);
-        fprintf(fp, "%-20s %-7.2f %-3s\n", records_ptr[i]->name, records_ptr[i]->score, g.letter_grade);
+        write_report_record(&w, &dataset[order[i]]);
     }
+    writer_clean(&w);
     
-    free(records_ptr);
+    free(scores);
+    free(order);
     return 1;
 }
+
+/*
+ * Write the report in binary columns: the header, then all names, all
+ * scores and all grades, each column in report order.
+ */
+int report_columns(FILE *fp, RECORD *dataset, STATS stats) {
+    if (fp == NULL || dataset == NULL || stats.count < 1)
+        return 0;
+    int count = stats.count;
+    float *scores;
+    int *order = report_order(dataset, count, &scores);
+    if (order == NULL)
+        return 0;
+    char magic[8] = REPORT_COLUMNS_MAGIC;
+    float header[3] = { stats.mean, stats.stddev, stats.median };
+    int ok = fwrite(magic, sizeof magic, 1, fp) == 1
+            && fwrite(&stats.count, sizeof(int), 1, fp) == 1
+            && fwrite(header, sizeof header, 1, fp) == 1;
+    REPORTWRITER w;
+    writer_init(&w, fp);
+    for (int i = 0; ok && i < count; i++) {
+        if (REPORT_BUFFER - w.used < 21)
+            writer_flush(&w);
+        char *name = w.buf + w.used;
+        const char *src = dataset[order[i]].name;
+        int len = strnlen(src, 20);
+        memcpy(name, src, len);
+        memset(name + len, 0, 21 - len);
+        w.used += 21;
+    }
+    writer_flush(&w);
+    ok = ok && fwrite(scores, sizeof(float), count, fp) == (size_t)count;
+    for (int i = 0; ok && i < count; i++) {
+        if (REPORT_BUFFER - w.used < 3)
+            writer_flush(&w);
+        char *letter = w.buf + w.used;
+        if (scores[i] >= 0 && scores[i] < 100) {
+            const char *t = grade_table[(int)scores[i]];
+            for (int k = 0; k < 3; k++)
+                letter[k] = (t[k] == ' ') ? '\0' : t[k];
+        } else {
+            GRADE g = grade(scores[i]);
+            int len = strnlen(g.letter_grade, 2);
+            memcpy(letter, g.letter_grade, len);
+            memset(letter + len, 0, 3 - len);
+        }
+        w.used += 3;
+    }
+    writer_clean(&w);
+    ok = ok && !ferror(fp);
+    free(scores);
+    free(order);
+    return ok;
+}
+
+/*
+ * A sorted run spilled to a temporary file, read back through two buffers:
+ * the merge takes records from the front buffer while the prefetch thread
+ * fills the back one.
+ */
+typedef struct {
+    FILE *fp;
+    int count;          /* records in the run */
+    RECORD *buf[2];
+    int len[2];         /* records in each buffer */
+    int front;          /* buffer being merged */
+    int pos;            /* next record of the front buffer */
+    int back_ready;     /* the back buffer has been filled */
+    int eof;            /* the whole run has been read */
+} RUNREADER;
+
+typedef struct {
+    RUNREADER *runs;
+    int nruns;
+    int chunk;          /* records per buffer */
+    int async;          /* a prefetch thread is running */
+    int stop;
+    pthread_mutex_t lock;
+    pthread_cond_t filled, wanted;
+} PREFETCH;
+
+/*
+ * Fill the back buffer of a run; called with the lock held, which is
+ * released during the read when a prefetch thread is running.
+ */
+static void fill_back(PREFETCH *pf, RUNREADER *rd) {
+    int back = 1 - rd->front;
+    if (pf->async)
+        pthread_mutex_unlock(&pf->lock);
+    int len = fread(rd->buf[back], sizeof(RECORD), pf->chunk, rd->fp);
+    if (pf->async)
+        pthread_mutex_lock(&pf->lock);
+    rd->len[back] = len;
+    rd->back_ready = 1;
+    if (len < pf->chunk)
+        rd->eof = 1;
+}
+
+static void *prefetch_runs(void *arg) {
+    PREFETCH *pf = (PREFETCH *)arg;
+    pthread_mutex_lock(&pf->lock);
+    while (!pf->stop) {
+        int r = 0;
+        while (r < pf->nruns && (pf->runs[r].back_ready || pf->runs[r].eof))
+            r++;
+        if (r == pf->nruns) {
+            pthread_cond_wait(&pf->wanted, &pf->lock);
+            continue;
+        }
+        fill_back(pf, &pf->runs[r]);
+        pthread_cond_broadcast(&pf->filled);
+    }
+    pthread_mutex_unlock(&pf->lock);
+    return NULL;
+}
+
+/*
+ * The next record of a run, or NULL at its end. When the front buffer is
+ * used up, wait for the back one and hand the old front to the prefetcher.
+ */
+static RECORD *run_next(PREFETCH *pf, RUNREADER *rd) {
+    if (rd->pos == rd->len[rd->front]) {
+        if (pf->async)
+            pthread_mutex_lock(&pf->lock);
+        else if (!rd->back_ready && !rd->eof)
+            fill_back(pf, rd);
+        while (!rd->back_ready && !rd->eof)
+            pthread_cond_wait(&pf->filled, &pf->lock);
+        int ready = rd->back_ready;
+        if (ready) {
+            rd->front = 1 - rd->front;
+            rd->pos = 0;
+            rd->back_ready = 0;
+            if (pf->async)
+                pthread_cond_signal(&pf->wanted);
+        }
+        if (pf->async)
+            pthread_mutex_unlock(&pf->lock);
+        if (!ready || rd->len[rd->front] == 0)
+            return NULL;
+    }
+    return &rd->buf[rd->front][rd->pos++];
+}
+
+/*
+ * Number of leading records of a run, sorted by decreasing score, whose
+ * score key is at least key; found by binary search with one read a probe.
+ */
+static int run_count_ge(RUNREADER *rd, unsigned key) {
+    int lo = 0, hi = rd->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        RECORD r;
+        fseek(rd->fp, (long)mid * sizeof(RECORD), SEEK_SET);
+        if (fread(&r, sizeof(RECORD), 1, rd->fp) != 1)
+            break;
+        if (float_key(r.score) >= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*
+ * The score of ascending rank k over all runs, by bisection on the score
+ * key: the largest key with more than count - 1 - k scores at or above it.
+ */
+static float runs_rank_score(RUNREADER *runs, int nruns, int count, int k) {
+    long long need = (long long)count - k;
+    unsigned lo = 0, hi = 0xffffffffu;
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2 + 1;
+        long long n = 0;
+        for (int r = 0; r < nruns; r++)
+            n += run_count_ge(&runs[r], mid);
+        if (n >= need)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return key_float(lo);
+}
+
+/*
+ * Heap order of the runs by their current record: higher score first, and
+ * on equal scores the earlier run, which keeps equal scores in input order.
+ */
+static int run_before(RECORD **head, int a, int b) {
+    unsigned ka = float_key(head[a]->score), kb = float_key(head[b]->score);
+    return ka > kb || (ka == kb && a < b);
+}
+
+static void run_sift(int *heap, int n, int i, RECORD **head) {
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= n)
+            return;
+        if (c + 1 < n && run_before(head, heap[c + 1], heap[c]))
+            c++;
+        if (!run_before(head, heap[c], heap[i]))
+            return;
+        int t = heap[i];
+        heap[i] = heap[c];
+        heap[c] = t;
+        i = c;
+    }
+}
+
+/*
+ * Sort the n records of a run by decreasing score, stably, and write them
+ * to fp in that order (or only sort them when fp is NULL), leaving the
+ * order in order[] and the sorted scores in keys[].
+ */
+static int sort_run(RECORD *run, float *keys, int *order, int n, FILE *fp) {
+    for (int i = 0; i < n; i++) {
+        keys[i] = run[i].score;
+        order[i] = i;
+    }
+    sort_float_keys(keys, order, n, 1);
+    if (fp == NULL)
+        return 1;
+    for (int i = 0; i < n; i++) {
+        if (fwrite(&run[order[i]], sizeof(RECORD), 1, fp) != 1)
+            return 0;
+    }
+    return fflush(fp) == 0;
+}
+
+/*
+ * External merge sort: runs of records that fit in the budget are sorted
+ * and spilled to temporary files while the statistics are accumulated, then
+ * the runs are merged with a heap and a prefetch thread reads ahead.
+ */
+int report_file(char *filename, FILE *fp, size_t memory_budget) {
+    if (filename == NULL || fp == NULL)
+        return 0;
+    FILE *in = fopen(filename, "r");
+    if (in == NULL) {
+        perror("open input file error");
+        return 0;
+    }
+    if (memory_budget == 0)
+        memory_budget = EXTERNAL_SORT_BUDGET;
+    // a record in a run also needs its key, index and two radix sort words
+    size_t per_record = sizeof(RECORD) + sizeof(float) + sizeof(int) + 2 * sizeof(unsigned long long);
+    size_t cap = memory_budget / per_record;
+    if (cap < 4)
+        cap = 4;
+    if (cap > (1u << 30) / per_record)
+        cap = (1u << 30) / per_record;
+    int capacity = (int)cap;
+    RECORD *run = (RECORD *)malloc(capacity * sizeof(RECORD));
+    float *keys = (float *)malloc(capacity * sizeof(float));
+    int *order = (int *)malloc(capacity * sizeof(int));
+    if (run == NULL || keys == NULL || order == NULL) {
+        fprintf(stderr, "Memory allocation failed in report_file()\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // pass 1: read the records into runs, spilling every full run
+    RUNREADER *runs = NULL;
+    int nruns = 0, n = 0, ok = 1;
+    STATS stats = { 0, 0, 0, 0 };
+    double mean = 0, m2 = 0;
+    char line[256];
+    RECORD r;
+    for (;;) {
+        int more = fgets(line, sizeof(line), in) != NULL;
+        if (more) {
+            char *eol = line + strcspn(line, "\n");
+            if (parse_record(line, eol, &r) <= 0)
+                continue;
+            double x = r.score;
+            stats.count++;
+            double d = x - mean;
+            mean += d / stats.count;
+            m2 += d * (x - mean);
+            run[n++] = r;
+        }
+        if ((n == capacity && more) || (!more && n > 0 && nruns > 0)) {
+            RUNREADER *t = (RUNREADER *)realloc(runs, (nruns + 1) * sizeof(RUNREADER));
+            if (t == NULL) {
+                fprintf(stderr, "Memory allocation failed in report_file()\n");
+                exit(EXIT_FAILURE);
+            }
+            runs = t;
+            memset(&runs[nruns], 0, sizeof(RUNREADER));
+            runs[nruns].fp = tmpfile();
+            runs[nruns].count = n;
+            if (runs[nruns].fp == NULL || !sort_run(run, keys, order, n, runs[nruns].fp)) {
+                perror("temporary run file error");
+                ok = 0;
+                nruns++;
+                break;
+            }
+            nruns++;
+            n = 0;
+        }
+        if (!more)
+            break;
+    }
+    fclose(in);
+    if (stats.count > 0) {
+        stats.mean = mean;
+        stats.stddev = sqrt(m2 / stats.count);
+    }
+
+    double h = 0.5 * (stats.count - 1);
+    int k = (int)h;
+    int top = (k + 1 < stats.count) ? k + 1 : k;
+    if (!ok || stats.count == 0) {
+        ok = 0;
+    } else if (nruns == 0) {
+        // everything fits in one run: sort and write it directly
+        sort_run(run, keys, order, n, NULL);
+        stats.median = interpolate_rank(keys[n - 1 - k], keys[n - 1 - top], h - k);
+        write_report_header(fp, stats);
+        REPORTWRITER w;
+        writer_init(&w, fp);
+        for (int i = 0; i < n; i++)
+            write_report_record(&w, &run[order[i]]);
+        writer_clean(&w);
+    } else {
+        free(run);
+        free(keys);
+        free(order);
+        run = NULL;
+        keys = NULL;
+        order = NULL;
+        float low = runs_rank_score(runs, nruns, stats.count, k);
+        float high = (top == k) ? low : runs_rank_score(runs, nruns, stats.count, top);
+        stats.median = interpolate_rank(low, high, h - k);
+        write_report_header(fp, stats);
+
+        // pass 2: merge, two read buffers a run within the budget
+        PREFETCH pf;
+        pf.runs = runs;
+        pf.nruns = nruns;
+        pf.chunk = (int)(memory_budget / (2 * nruns * sizeof(RECORD)));
+        if (pf.chunk < 1)
+            pf.chunk = 1;
+        pf.stop = 0;
+        for (int i = 0; i < nruns; i++) {
+            runs[i].buf[0] = (RECORD *)malloc(pf.chunk * sizeof(RECORD));
+            runs[i].buf[1] = (RECORD *)malloc(pf.chunk * sizeof(RECORD));
+            if (runs[i].buf[0] == NULL || runs[i].buf[1] == NULL) {
+                fprintf(stderr, "Memory allocation failed in report_file()\n");
+                exit(EXIT_FAILURE);
+            }
+            rewind(runs[i].fp);
+        }
+        pthread_mutex_init(&pf.lock, NULL);
+        pthread_cond_init(&pf.filled, NULL);
+        pthread_cond_init(&pf.wanted, NULL);
+        pthread_t thread;
+        pf.async = 1;
+        if (pthread_create(&thread, NULL, prefetch_runs, &pf) != 0)
+            pf.async = 0;   // read synchronously instead
+
+        RECORD **head = (RECORD **)malloc(nruns * sizeof(RECORD *));
+        int *heap = (int *)malloc(nruns * sizeof(int));
+        if (head == NULL || heap == NULL) {
+            fprintf(stderr, "Memory allocation failed in report_file()\n");
+            exit(EXIT_FAILURE);
+        }
+        int size = 0;
+        for (int i = 0; i < nruns; i++) {
+            head[i] = run_next(&pf, &runs[i]);
+            if (head[i] != NULL)
+                heap[size++] = i;
+        }
+        for (int i = size / 2 - 1; i >= 0; i--)
+            run_sift(heap, size, i, head);
+        REPORTWRITER w;
+        writer_init(&w, fp);
+        while (size > 0) {
+            int i = heap[0];
+            write_report_record(&w, head[i]);
+            head[i] = run_next(&pf, &runs[i]);
+            if (head[i] == NULL)
+                heap[0] = heap[--size];
+            run_sift(heap, size, 0, head);
+        }
+        writer_clean(&w);
+
+        if (pf.async) {
+            pthread_mutex_lock(&pf.lock);
+            pf.stop = 1;
+            pthread_cond_signal(&pf.wanted);
+            pthread_mutex_unlock(&pf.lock);
+            pthread_join(thread, NULL);
+        }
+        pthread_mutex_destroy(&pf.lock);
+        pthread_cond_destroy(&pf.filled);
+        pthread_cond_destroy(&pf.wanted);
+        free(head);
+        free(heap);
+    }
+
+    for (int i = 0; i < nruns; i++) {
+        if (runs[i].fp != NULL)
+            fclose(runs[i].fp);
+        free(runs[i].buf[0]);
+        free(runs[i].buf[1]);
+    }
+    free(runs);
+    free(run);
+    free(keys);
+    free(order);
+    return ok;
+}
@@ -12,6 +12,25 @@ typedef struct {
     float score;
 } RECORD;
 
+/*
+ * Structure to hold records imported by import_records().
+ * With a caller buffer (growable 0) at most capacity records are stored
+ * and total tells how many the file had; otherwise records is grown with
+ * realloc() and must be released with recordset_clean().
+ */
+typedef struct {
+    RECORD *records;
+    int count;          /* records stored */
+    int capacity;       /* length of records */
+    int growable;       /* 1 if records is owned and grown by import_records() */
+    int total;          /* valid records in the file, > count if truncated */
+    int malformed;      /* number of malformed lines */
+    int first_malformed;   /* line number of the first malformed line, 0 if none */
+                           /* (counts accumulate over imports into the same set) */
+} RECORDSET;
+
+#define IMPORT_MAX_REPORTS 10   /* malformed lines printed to stderr per import */
+
 /*
  * Structure to hold basic statistics computed from the record data.
  */
@@ -22,6 +41,32 @@ typedef struct {
     float median;
 } STATS;
 
+/*
+ * A t-digest centroid: the mean and weight of a cluster of values.
+ */
+typedef struct {
+    double mean;
+    double weight;
+} CENTROID;
+
+#define TDIGEST_COMPRESSION 100   /* default compression of a t-digest */
+
+/*
+ * Structure of a merging t-digest, a summary of a stream of values in
+ * O(compression) space that answers quantile queries, most accurately near
+ * the tails. New values are buffered after the merged centroids and are
+ * merged in when the array is full or a quantile is asked for.
+ */
+typedef struct {
+    double compression;
+    CENTROID *centroids;   /* merged centroids by increasing mean, then the buffer */
+    int merged;            /* number of merged centroids */
+    int buffered;          /* number of buffered values */
+    int capacity;          /* length of centroids */
+    double weight;         /* number of values added */
+    double min, max;
+} TDIGEST;
+
 /*
  * Structure to hold a letter grade.
  * The letter grade is stored as a string of up to 2 letters plus a null terminator.
@@ -49,6 +94,36 @@ GRADE grade(float score);
  */
 int import_data(FILE *fp, RECORD *dataset); 
 
+/*
+ * Initialize a record set.
+ *
+ * @param rs - the record set.
+ * @param buffer - caller RECORD array, or NULL for a growable set.
+ * @param capacity - length of buffer (ignored for a growable set).
+ */
+void recordset_init(RECORDSET *rs, RECORD *buffer, int capacity);
+
+/*
+ * Free the records of a growable record set and reset it.
+ */
+void recordset_clean(RECORDSET *rs);
+
+/*
+ * Import name,score lines from a file by memory-mapping it, appending to rs.
+ * A line is valid if it has a nonempty name, a comma and a decimal number
+ * (optionally surrounded by blanks); names are truncated to 20 characters
+ * as in import_data(). Blank lines are skipped; other lines are counted as
+ * malformed and the first IMPORT_MAX_REPORTS of them are printed to stderr.
+ * With nthreads > 1 the file is cut into chunks at line boundaries that are
+ * parsed in parallel and appended in file order.
+ *
+ * @param filename - name of the input file.
+ * @param rs - an initialized record set.
+ * @param nthreads - number of threads, at least 1.
+ * @return - the number of records stored, or -1 if the file cannot be read.
+ */
+int import_records(char *filename, RECORDSET *rs, int nthreads);
+
 /*
  * Process the record data by computing the average, standard deviation,
  * and median of the score values. Returns a STATS structure with the results.
@@ -59,6 +134,59 @@ int import_data(FILE *fp, RECORD *dataset);
  */
 STATS process_data(RECORD *dataset, int count);
 
+/*
+ * Compute quantiles of the scores in expected linear time, by selection on
+ * a copy of the scores. The quantile q is interpolated between the values
+ * of rank floor(q * (count - 1)) and the next one, so 0.5 gives the median
+ * of process_data().
+ *
+ * @param dataset - input record data array.
+ * @param count - number of records in the dataset array.
+ * @param q - m quantiles in [0, 1], in any order, e.g. 0.9 and 0.99.
+ * @param values - array to store the m quantile values.
+ * @param m - number of quantiles.
+ * @return - m if successful, 0 otherwise.
+ */
+int quantiles(RECORD *dataset, int count, const float *q, float *values, int m);
+
+/*
+ * Initialize an empty t-digest.
+ *
+ * @param td - the t-digest.
+ * @param compression - accuracy parameter, or 0 for TDIGEST_COMPRESSION.
+ */
+void tdigest_init(TDIGEST *td, double compression);
+
+/*
+ * Add a value to a t-digest.
+ */
+void tdigest_add(TDIGEST *td, double value);
+
+/*
+ * Estimate the quantile q in [0, 1] of the values added to a t-digest.
+ *
+ * @return - the estimate, or 0 if the t-digest is empty.
+ */
+double tdigest_quantile(TDIGEST *td, double q);
+
+/*
+ * Free the centroids of a t-digest.
+ */
+void tdigest_clean(TDIGEST *td);
+
+/*
+ * Compute the statistics of name,score lines read from fp without storing
+ * them: the mean and standard deviation are exact, the median is estimated
+ * by the t-digest td, which also receives every score for further quantile
+ * queries. Lines are read as by import_records() and malformed ones skipped;
+ * lines must be shorter than 256 characters.
+ *
+ * @param fp - FILE pointer to the input file.
+ * @param td - an initialized t-digest.
+ * @return - computed statistics as a STATS structure.
+ */
+STATS process_stream(FILE *fp, TDIGEST *td);
+
 /*
  * Prepare and write a report (including statistics and letter grades)
  * to the output file. The records in the report are sorted in decreasing order of score.
@@ -70,4 +198,44 @@ STATS process_data(RECORD *dataset, int count);
  */
 int report_data(FILE *fp, RECORD *dataset, STATS stats);
 
+#define REPORT_COLUMNS_MAGIC "RECCOL1"   /* first 8 bytes of a columnar report, with the NUL */
+
+/*
+ * Write the report of report_data() in binary columns for other programs,
+ * in the byte order of this machine:
+ *   char magic[8]            REPORT_COLUMNS_MAGIC
+ *   int count
+ *   float mean, stddev, median
+ *   char name[count][21]     NUL-padded names
+ *   float score[count]
+ *   char grade[count][3]     NUL-padded letter grades
+ * Each column lists the records in the order of report_data().
+ *
+ * @param fp - FILE pointer to the output file, opened in binary mode.
+ * @param dataset - array of RECORD data.
+ * @param stats - the computed statistics.
+ * @return - returns 1 if successful; 0 if there are no records or a write failed.
+ */
+int report_columns(FILE *fp, RECORD *dataset, STATS stats);
+
+#define EXTERNAL_SORT_BUDGET (64 << 20)   /* default memory budget of report_file(), bytes */
+
+/*
+ * Write the report of the name,score lines of a file as report_data() writes
+ * it for the same records and their process_data() statistics, using about
+ * memory_budget bytes whatever the size of the file. Records are read into
+ * runs that fit in the budget; each run is sorted by decreasing score and
+ * spilled to a temporary file, and the runs are merged with a heap while a
+ * thread reads ahead into a second buffer of every run. The median is
+ * found before the merge by binary search over the sorted runs. A file
+ * that fits in one run is reported without temporary files. Lines are read
+ * as by process_stream().
+ *
+ * @param filename - name of the input file.
+ * @param fp - FILE pointer to the output file.
+ * @param memory_budget - bytes of memory to use, or 0 for EXTERNAL_SORT_BUDGET.
+ * @return - 1 if successful; 0 if there are no records or an error occurred.
+ */
+int report_file(char *filename, FILE *fp, size_t memory_budget);
+
 #endif /* MYRECORD_H */
@@ -11,7 +11,10 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <time.h>
+#include <unistd.h>
 #include "myrecord.h"
+#include "mysort.h"
 
 #define MAX_REC 100
 #define MAX_LINE_LEN 100
@@ -113,10 +116,466 @@ void test_report_data() {
 	printf("\n");
 }
 
+void test_import_records() {
+	printf("------------------\n");
+	printf("Test: import_records\n\n");
+
+	RECORD dataset[MAX_REC];
+	RECORDSET rs;
+	recordset_init(&rs, dataset, 4);
+	int count = import_records(infilename, &rs, 1);
+	printf("import_records(buffer of 4):%d, total:%d, malformed:%d\n", count, rs.total, rs.malformed);
+
+	for (int nthreads = 1; nthreads <= 2; nthreads++) {
+		recordset_init(&rs, NULL, 0);
+		count = import_records(infilename, &rs, nthreads);
+		printf("import_records(growable, %d thread(s)):%d, total:%d, malformed:%d\n", nthreads,
+				count, rs.total, rs.malformed);
+		for (int i = 0; i < count; i++) {
+			printf(data_format, rs.records[i].name, rs.records[i].score);
+		}
+		recordset_clean(&rs);
+	}
+
+	// malformed lines are reported with their line numbers
+	char filename[] = "/tmp/myrecord_XXXXXX";
+	int fd = mkstemp(filename);
+	FILE *fp = (fd < 0) ? NULL : fdopen(fd, "w");
+	if (fp == NULL) {
+		perror("temporary file error");
+		return;
+	}
+	fprintf(fp, "A1,10\nno comma\n\nA2, 20.5 \r\nA3,abc\n,30\nA4,1e1\n");
+	fclose(fp);
+	recordset_init(&rs, NULL, 0);
+	count = import_records(filename, &rs, 1);
+	fflush(stderr);
+	printf("import_records(bad lines):%d, malformed:%d, first at line:%d\n", count, rs.malformed,
+			rs.first_malformed);
+	for (int i = 0; i < count; i++) {
+		printf(data_format, rs.records[i].name, rs.records[i].score);
+	}
+	recordset_clean(&rs);
+	remove(filename);
+	printf("\n");
+}
+
+void test_quantiles() {
+	printf("------------------\n");
+	printf("Test: quantiles\n\n");
+	RECORD dataset[MAX_REC];
+	FILE *fp = fopen(infilename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	int count = import_data(fp, dataset);
+	fclose(fp);
+	float q[] = { 0.99, 0.5, 0, 0.9, 1, 0.25 };
+	int m = sizeof q / sizeof *q;
+	float values[6];
+	if (quantiles(dataset, count, q, values, m) == m) {
+		for (int i = 0; i < m; i++) {
+			printf("quantile(%.2f): %.1f\n", q[i], values[i]);
+		}
+	}
+	printf("\n");
+}
+
+void test_process_stream() {
+	printf("------------------\n");
+	printf("Test: process_stream\n\n");
+	FILE *fp = fopen(infilename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	TDIGEST td;
+	tdigest_init(&td, 0);
+	STATS stats = process_stream(fp, &td);
+	fclose(fp);
+	printf("%-10s%-6d\n", "count", stats.count);
+	printf(stats_format, "mean", stats.mean);
+	printf(stats_format, "stddev", stats.stddev);
+	printf(stats_format, "median", stats.median);
+	printf(stats_format, "p90", tdigest_quantile(&td, 0.9));
+	tdigest_clean(&td);
+	printf("\n");
+}
+
+/*
+ * Write the report of a file through import_records(), process_data() and
+ * report_data() to outname.
+ */
+int report_in_memory(char *filename, char *outname) {
+	RECORDSET rs;
+	recordset_init(&rs, NULL, 0);
+	import_records(filename, &rs, 1);
+	FILE *fp = fopen(outname, "w");
+	int ok = fp != NULL && report_data(fp, rs.records, process_data(rs.records, rs.count));
+	if (fp != NULL)
+		fclose(fp);
+	recordset_clean(&rs);
+	return ok;
+}
+
+int same_files(char *name1, char *name2) {
+	FILE *f1 = fopen(name1, "r"), *f2 = fopen(name2, "r");
+	int same = f1 != NULL && f2 != NULL;
+	while (same) {
+		int c1 = fgetc(f1), c2 = fgetc(f2);
+		same = c1 == c2;
+		if (c1 == EOF)
+			break;
+	}
+	if (f1 != NULL)
+		fclose(f1);
+	if (f2 != NULL)
+		fclose(f2);
+	return same;
+}
+
+/*
+ * Write n random records with many equal scores to a temporary file.
+ */
+long make_records(char *filename, int n) {
+	int fd = mkstemp(filename);
+	FILE *fp = (fd < 0) ? NULL : fdopen(fd, "w");
+	if (fp == NULL) {
+		perror("temporary file error");
+		return -1;
+	}
+	for (int i = 0; i < n; i++) {
+		fprintf(fp, "Student%d,%d.%d\n", i, rand() % 100, rand() % 10);
+	}
+	long size = ftell(fp);
+	fclose(fp);
+	return size;
+}
+
+void test_report_file() {
+	printf("------------------\n");
+	printf("Test: report_file\n\n");
+	char filename[] = "/tmp/myrecord_XXXXXX";
+	char expected[] = "/tmp/myrecord_expected.txt";
+	char actual[] = "/tmp/myrecord_actual.txt";
+	srand(1);
+	if (make_records(filename, 5000) < 0)
+		return;
+	report_in_memory(filename, expected);
+	size_t budgets[] = { 0, 16 << 10, 1 };
+	for (int i = 0; i < (int) (sizeof budgets / sizeof *budgets); i++) {
+		FILE *fp = fopen(actual, "w");
+		int ok = report_file(filename, fp, budgets[i]);
+		fclose(fp);
+		printf("report_file(5000 records, budget %zu): %d, same as report_data: %d\n", budgets[i], ok,
+				same_files(expected, actual));
+	}
+	remove(filename);
+	remove(expected);
+	remove(actual);
+	printf("\n");
+}
+
+/*
+ * Records in decreasing order of score, written as report_data() used to.
+ */
+void report_reference(FILE *fp, RECORD *dataset, STATS stats) {
+	fprintf(fp, "Record Count: %d\n", stats.count);
+	fprintf(fp, "Mean: %.2f\n", stats.mean);
+	fprintf(fp, "Standard Deviation: %.2f\n", stats.stddev);
+	fprintf(fp, "Median: %.2f\n", stats.median);
+	fprintf(fp, "\nRecords (sorted in decreasing order of scores):\n");
+	fprintf(fp, "-----------------------------------------------\n");
+	fprintf(fp, "%-20s %-7s %-3s\n", "Name", "Score", "Grade");
+	fprintf(fp, "-----------------------------------------------\n");
+	for (int i = 0; i < stats.count; i++) {
+		GRADE g = grade(dataset[i].score);
+		fprintf(fp, "%-20s %-7.2f %-3s\n", dataset[i].name, dataset[i].score, g.letter_grade);
+	}
+}
+
+void test_report_format() {
+	printf("------------------\n");
+	printf("Test: report_data format\n\n");
+	float scores[] = { 1e20, 12345.678, 100.5, 100, 99.995, 90, 89.999, 85, 2.675, 0.125, 0.005, 0,
+			-0.001, -2.5 };
+	int count = sizeof scores / sizeof *scores;
+	RECORD dataset[MAX_REC];
+	for (int i = 0; i < count; i++) {
+		sprintf(dataset[i].name, i == 0 ? "ABCDEFGHIJKLMNOPQRST" : "R%d", i);
+		dataset[i].score = scores[i];
+	}
+	STATS stats = process_data(dataset, count);
+	char expected[] = "/tmp/myrecord_expected.txt";
+	char actual[] = "/tmp/myrecord_actual.txt";
+	FILE *fp = fopen(expected, "w");
+	report_reference(fp, dataset, stats);
+	fclose(fp);
+	fp = fopen(actual, "w");
+	report_data(fp, dataset, stats);
+	fclose(fp);
+	printf("report_data(%d edge scores) same as fprintf: %d\n", count, same_files(expected, actual));
+	remove(expected);
+	remove(actual);
+	printf("\n");
+}
+
+void test_report_columns() {
+	printf("------------------\n");
+	printf("Test: report_columns\n\n");
+	RECORD dataset[MAX_REC];
+	FILE *fp = fopen(infilename, "r");
+	if (fp == NULL) {
+		perror("open input file error");
+		return;
+	}
+	int count = import_data(fp, dataset);
+	fclose(fp);
+	fp = tmpfile();
+	if (fp == NULL || !report_columns(fp, dataset, process_data(dataset, count))) {
+		printf("report_columns failed\n");
+		return;
+	}
+	rewind(fp);
+	char magic[8];
+	int n;
+	float header[3];
+	fread(magic, sizeof magic, 1, fp);
+	fread(&n, sizeof n, 1, fp);
+	fread(header, sizeof header, 1, fp);
+	printf("magic: %s, count: %d, mean: %.2f, stddev: %.2f, median: %.2f\n", magic, n, header[0],
+			header[1], header[2]);
+	char (*names)[21] = malloc(n * sizeof *names);
+	float *column = malloc(n * sizeof(float));
+	char (*letters)[3] = malloc(n * sizeof *letters);
+	fread(names, sizeof *names, n, fp);
+	fread(column, sizeof(float), n, fp);
+	fread(letters, sizeof *letters, n, fp);
+	for (int i = 0; i < n; i++) {
+		printf("%-10s%-6.1f%.3s\n", names[i], column[i], letters[i]);
+	}
+	free(names);
+	free(column);
+	free(letters);
+	fclose(fp);
+	printf("\n");
+}
+
+double wall_time() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Write n random name,score lines to a temporary file and time import_data()
+ * against import_records() with 1, 2 and 4 threads.
+ */
+void time_test_import(int n) {
+	printf("------------------\n");
+	printf("Test: runtime, import %d records\n\n", n);
+	char filename[] = "/tmp/myrecord_XXXXXX";
+	int fd = mkstemp(filename);
+	FILE *fp = (fd < 0) ? NULL : fdopen(fd, "w");
+	if (fp == NULL) {
+		perror("temporary file error");
+		return;
+	}
+	for (int i = 0; i < n; i++) {
+		fprintf(fp, "Student%d,%d.%d\n", i, rand() % 100, rand() % 10);
+	}
+	long size = ftell(fp);
+	fclose(fp);
+
+	RECORD *dataset = malloc((size_t) n * sizeof(RECORD));
+	fp = fopen(filename, "r");
+	double t1 = wall_time();
+	int count = import_data(fp, dataset);
+	double t = wall_time() - t1;
+	fclose(fp);
+	printf("import_data:             %0.3f (s), %6.0f MB/s, records: %d\n", t, size / t / 1e6, count);
+
+	for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+		RECORDSET rs;
+		recordset_init(&rs, NULL, 0);
+		t1 = wall_time();
+		count = import_records(filename, &rs, nthreads);
+		t = wall_time() - t1;
+		int same = count == n;
+		for (int i = 0; same && i < n; i++) {
+			same = strcmp(rs.records[i].name, dataset[i].name) == 0 && rs.records[i].score == dataset[i].score;
+		}
+		printf("import_records %d thread(s): %0.3f (s), %6.0f MB/s, records: %d, same: %d\n", nthreads, t,
+				size / t / 1e6, count, same);
+		recordset_clean(&rs);
+	}
+
+	// a caller buffer of half the records with 4 threads keeps the first half
+	RECORD *half = malloc((size_t) (n / 2 + 1) * sizeof(RECORD));
+	RECORDSET rs;
+	recordset_init(&rs, half, n / 2);
+	count = import_records(filename, &rs, 4);
+	int same = count == n / 2 && rs.total == n;
+	for (int i = 0; same && i < count; i++) {
+		same = strcmp(half[i].name, dataset[i].name) == 0 && half[i].score == dataset[i].score;
+	}
+	printf("import_records 4 thread(s), buffer of %d: records: %d, total: %d, same: %d\n", n / 2,
+			count, rs.total, same);
+	free(half);
+	free(dataset);
+	remove(filename);
+	printf("\n");
+}
+
+/*
+ * Median by sorting record pointers, as process_data() used to do.
+ */
+static int compare_score(void *p1, void *p2) {
+	float a = ((RECORD *) p1)->score, b = ((RECORD *) p2)->score;
+	return (a > b) - (a < b);
+}
+
+float median_by_sort(RECORD *dataset, int count) {
+	RECORD **p = malloc(count * sizeof(RECORD *));
+	for (int i = 0; i < count; i++) {
+		p[i] = &dataset[i];
+	}
+	my_sort((void **) p, 0, count - 1, compare_score);
+	float median = (count % 2) ? p[count / 2]->score : (p[count / 2 - 1]->score + p[count / 2]->score) / 2.0;
+	free(p);
+	return median;
+}
+
+/*
+ * Time the median of n random scores by sorting and by process_data(), and
+ * compare t-digest quantiles with exact ones.
+ */
+void time_test_process(int n) {
+	printf("------------------\n");
+	printf("Test: runtime, process %d records\n\n", n);
+	RECORD *dataset = malloc((size_t) n * sizeof(RECORD));
+	for (int i = 0; i < n; i++) {
+		sprintf(dataset[i].name, "Student%d", i);
+		dataset[i].score = (rand() % 100000) / 1000.0;
+	}
+	double t1 = wall_time();
+	float median = median_by_sort(dataset, n);
+	double t = wall_time() - t1;
+	printf("my_sort median:   %0.3f (s), median: %.3f\n", t, median);
+	t1 = wall_time();
+	STATS stats = process_data(dataset, n);
+	t = wall_time() - t1;
+	printf("process_data:     %0.3f (s), median: %.3f, mean: %.3f, stddev: %.3f\n", t, stats.median,
+			stats.mean, stats.stddev);
+
+	float q[] = { 0.5, 0.9, 0.99, 0.999 };
+	float exact[4];
+	t1 = wall_time();
+	quantiles(dataset, n, q, exact, 4);
+	t = wall_time() - t1;
+	printf("quantiles:        %0.3f (s)\n", t);
+	TDIGEST td;
+	tdigest_init(&td, 0);
+	t1 = wall_time();
+	for (int i = 0; i < n; i++) {
+		tdigest_add(&td, dataset[i].score);
+	}
+	tdigest_quantile(&td, 0.5);   // merges the buffer
+	t = wall_time() - t1;
+	printf("tdigest_add:      %0.3f (s), centroids: %d\n", t, td.merged);
+	for (int i = 0; i < 4; i++) {
+		printf("q %.3f: exact %.3f, t-digest %.3f\n", q[i], exact[i], tdigest_quantile(&td, q[i]));
+	}
+	tdigest_clean(&td);
+	free(dataset);
+	printf("\n");
+}
+
+/*
+ * Time the report of n records in memory and by report_file() with a
+ * budget of an eighth of the file.
+ */
+void time_test_report(int n) {
+	printf("------------------\n");
+	printf("Test: runtime, report %d records\n\n", n);
+	char filename[] = "/tmp/myrecord_XXXXXX";
+	char expected[] = "/tmp/myrecord_expected.txt";
+	char actual[] = "/tmp/myrecord_actual.txt";
+	long size = make_records(filename, n);
+	if (size < 0)
+		return;
+	double t1 = wall_time();
+	report_in_memory(filename, expected);
+	double t = wall_time() - t1;
+	printf("report_data:      %0.3f (s)\n", t);
+	t1 = wall_time();
+	FILE *fp = fopen(actual, "w");
+	report_file(filename, fp, size / 8);
+	fclose(fp);
+	t = wall_time() - t1;
+	printf("report_file(%ld): %0.3f (s), same: %d\n", size / 8, t, same_files(expected, actual));
+	remove(filename);
+	remove(expected);
+	remove(actual);
+	printf("\n");
+}
+
+/*
+ * Time writing a report of n records with fprintf() and with report_data().
+ */
+void time_test_write(int n) {
+	printf("------------------\n");
+	printf("Test: runtime, write a report of %d records\n\n", n);
+	RECORD *dataset = malloc((size_t) n * sizeof(RECORD));
+	for (int i = 0; i < n; i++) {
+		sprintf(dataset[i].name, "Student%d", i);
+		dataset[i].score = 100 - (float) i / n * 100;
+	}
+	STATS stats = process_data(dataset, n);
+	char expected[] = "/tmp/myrecord_expected.txt";
+	char actual[] = "/tmp/myrecord_actual.txt";
+	double t1 = wall_time();
+	FILE *fp = fopen(expected, "w");
+	report_reference(fp, dataset, stats);
+	fclose(fp);
+	double t = wall_time() - t1;
+	printf("fprintf:        %0.3f (s)\n", t);
+	t1 = wall_time();
+	fp = fopen(actual, "w");
+	report_data(fp, dataset, stats);
+	fclose(fp);
+	t = wall_time() - t1;
+	printf("report_data:    %0.3f (s), same: %d\n", t, same_files(expected, actual));
+	t1 = wall_time();
+	fp = fopen(actual, "wb");
+	report_columns(fp, dataset, stats);
+	fclose(fp);
+	t = wall_time() - t1;
+	printf("report_columns: %0.3f (s)\n", t);
+	remove(expected);
+	remove(actual);
+	free(dataset);
+	printf("\n");
+}
+
 int main(int argc, char *args[]) {
+	if (argc > 1) {
+		time_test_import(atoi(args[1]));
+		time_test_process(atoi(args[1]));
+		time_test_report(atoi(args[1]));
+		time_test_write(atoi(args[1]));
+		return 0;
+	}
 	test_grade();
 	test_import_data();
 	test_process_data();
 	test_report_data();
+	test_import_records();
+	test_quantiles();
+	test_process_stream();
+	test_report_file();
+	test_report_format();
+	test_report_columns();
 	return 0;
 }
@@ -1,4 +1,9 @@
 #include "mysort.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
 
 /* 
  * Auxiliary function to swap two elements in the array.
@@ -25,33 +30,252 @@ static int default_compare(void *p1, void *p2) {
         return 0;
 }
 
+#define INSERTION_SORT_THRESHOLD 24   /* ranges shorter than this are insertion sorted */
+#define NINTHER_THRESHOLD 128         /* ranges longer than this use a ninther pivot */
+#define PARTIAL_INSERTION_LIMIT 8     /* moves allowed when trying to finish a range early */
+#define RADIX_SORT_THRESHOLD 64       /* shorter key arrays are insertion sorted */
+#define RADIX_BITS 11                 /* key bits sorted per radix pass */
+
+/*
+ * Insertion sort of a[begin..end-1]. If unguarded, a[begin-1] is known to
+ * be no greater than any element of the range and ends the inner loop.
+ */
+static void insertion_sort(void *a[], int begin, int end, int unguarded,
+        int (*cmp)(void*, void*)) {
+    for (int i = begin + 1; i < end; i++) {
+        void *t = a[i];
+        int j = i;
+        if (unguarded) {
+            while (cmp(t, a[j - 1]) < 0) {
+                a[j] = a[j - 1];
+                j--;
+            }
+        } else {
+            while (j > begin && cmp(t, a[j - 1]) < 0) {
+                a[j] = a[j - 1];
+                j--;
+            }
+        }
+        a[j] = t;
+    }
+}
+
+/*
+ * Insertion sort of a[begin..end-1] that gives up once more than
+ * PARTIAL_INSERTION_LIMIT elements have been moved.
+ * Returns 1 if the range is sorted, 0 if it gave up.
+ */
+static int partial_insertion_sort(void *a[], int begin, int end, int (*cmp)(void*, void*)) {
+    int moves = 0;
+    for (int i = begin + 1; i < end; i++) {
+        void *t = a[i];
+        int j = i;
+        while (j > begin && cmp(t, a[j - 1]) < 0) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = t;
+        moves += i - j;
+        if (moves > PARTIAL_INSERTION_LIMIT)
+            return 0;
+    }
+    return 1;
+}
+
 /*
- * Partition function used in quick sort.
- * It reorders the array segment [left, right] so that all elements less than or equal to 
- * the pivot are to its left and the others to its right. Returns the final pivot index.
+ * Order a[i] <= a[j] <= a[k].
  */
-static int partition(void *a[], int left, int right, int (*cmp)(void*, void*)) {
-    void *pivot = a[right];  // Choose the rightmost element as the pivot.
-    int i = left - 1;
-    int j;
-    for (j = left; j < right; j++) {
-        if (cmp(a[j], pivot) <= 0) {
-            i++;
+static void sort3(void *a[], int i, int j, int k, int (*cmp)(void*, void*)) {
+    if (cmp(a[j], a[i]) < 0)
+        swap(&a[i], &a[j]);
+    if (cmp(a[k], a[j]) < 0) {
+        swap(&a[j], &a[k]);
+        if (cmp(a[j], a[i]) < 0)
             swap(&a[i], &a[j]);
+    }
+}
+
+/*
+ * Heap sort of a[begin..end-1], the O(n log n) fallback of pdq_sort.
+ */
+static void sift_down(void *a[], int begin, int n, int i, int (*cmp)(void*, void*)) {
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= n)
+            return;
+        if (c + 1 < n && cmp(a[begin + c], a[begin + c + 1]) < 0)
+            c++;
+        if (cmp(a[begin + i], a[begin + c]) >= 0)
+            return;
+        swap(&a[begin + i], &a[begin + c]);
+        i = c;
+    }
+}
+
+static void heap_sort(void *a[], int begin, int end, int (*cmp)(void*, void*)) {
+    int n = end - begin;
+    for (int i = n / 2 - 1; i >= 0; i--)
+        sift_down(a, begin, n, i, cmp);
+    for (int m = n - 1; m > 0; m--) {
+        swap(&a[begin], &a[begin + m]);
+        sift_down(a, begin, m, 0, cmp);
+    }
+}
+
+/*
+ * Partition a[begin..end-1] around the pivot a[begin]: elements less than
+ * the pivot go to its left, the others to its right. Sets *already if no
+ * element had to be swapped. Returns the final pivot index.
+ */
+static int partition_right(void *a[], int begin, int end, int *already,
+        int (*cmp)(void*, void*)) {
+    void *pivot = a[begin];
+    int first = begin, last = end;
+    // the median-of-3 pivot selection leaves an element >= pivot at the end
+    while (cmp(a[++first], pivot) < 0)
+        ;
+    if (first - 1 == begin) {
+        while (first < last && cmp(a[--last], pivot) >= 0)
+            ;
+    } else {
+        while (cmp(a[--last], pivot) >= 0)
+            ;
+    }
+    *already = (first >= last);
+    while (first < last) {
+        swap(&a[first], &a[last]);
+        while (cmp(a[++first], pivot) < 0)
+            ;
+        while (cmp(a[--last], pivot) >= 0)
+            ;
+    }
+    int pivot_pos = first - 1;
+    a[begin] = a[pivot_pos];
+    a[pivot_pos] = pivot;
+    return pivot_pos;
+}
+
+/*
+ * Partition a[begin..end-1] around the pivot a[begin] with the elements
+ * equal to the pivot going to its left. Used when the pivot equals the
+ * element before the range: those equal elements are then in their final
+ * place, which makes this the three-way step for runs of duplicates.
+ * Returns the final pivot index.
+ */
+static int partition_left(void *a[], int begin, int end, int (*cmp)(void*, void*)) {
+    void *pivot = a[begin];
+    int first = begin, last = end;
+    while (cmp(pivot, a[--last]) < 0)
+        ;
+    if (last + 1 == end) {
+        while (first < last && cmp(pivot, a[++first]) >= 0)
+            ;
+    } else {
+        while (cmp(pivot, a[++first]) >= 0)
+            ;
+    }
+    while (first < last) {
+        swap(&a[first], &a[last]);
+        while (cmp(pivot, a[--last]) < 0)
+            ;
+        while (cmp(pivot, a[++first]) >= 0)
+            ;
+    }
+    int pivot_pos = last;
+    a[begin] = a[pivot_pos];
+    a[pivot_pos] = pivot;
+    return pivot_pos;
+}
+
+/*
+ * Swap a few elements of a side left unbalanced by a bad pivot, to break up
+ * the pattern that caused it.
+ */
+static void break_patterns(void *a[], int begin, int end) {
+    int size = end - begin;
+    if (size < INSERTION_SORT_THRESHOLD)
+        return;
+    int q = size / 4;
+    swap(&a[begin], &a[begin + q]);
+    swap(&a[end - 1], &a[end - q]);
+    if (size > NINTHER_THRESHOLD) {
+        swap(&a[begin + 1], &a[begin + q + 1]);
+        swap(&a[begin + 2], &a[begin + q + 2]);
+        swap(&a[end - 2], &a[end - q - 1]);
+        swap(&a[end - 3], &a[end - q - 2]);
+    }
+}
+
+/*
+ * Pattern-defeating quick sort (Orson Peters' pdqsort) of a[begin..end-1].
+ * The pivot is the median of 3 or, for long ranges, a ninther. A range
+ * whose pivot equals its predecessor is split with partition_left(), so
+ * duplicates take linear time. A partition that moved nothing is finished
+ * by bounded insertion sorts, so sorted runs take linear time. Each very
+ * unbalanced partition shuffles a few elements and uses up one of
+ * bad_allowed, after which the range is heap sorted. Recursion goes to the
+ * smaller side, so the depth is O(log n).
+ */
+static void pdq_sort(void *a[], int begin, int end, int bad_allowed, int leftmost,
+        int (*cmp)(void*, void*)) {
+    for (;;) {
+        int size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            insertion_sort(a, begin, end, !leftmost, cmp);
+            return;
+        }
+        int s2 = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(a, begin, begin + s2, end - 1, cmp);
+            sort3(a, begin + 1, begin + s2 - 1, end - 2, cmp);
+            sort3(a, begin + 2, begin + s2 + 1, end - 3, cmp);
+            sort3(a, begin + s2 - 1, begin + s2, begin + s2 + 1, cmp);
+            swap(&a[begin], &a[begin + s2]);
+        } else {
+            sort3(a, begin + s2, begin, end - 1, cmp);
+        }
+
+        if (!leftmost && cmp(a[begin - 1], a[begin]) >= 0) {
+            begin = partition_left(a, begin, end, cmp) + 1;
+            continue;
+        }
+
+        int already;
+        int pivot_pos = partition_right(a, begin, end, &already, cmp);
+        int l_size = pivot_pos - begin;
+        int r_size = end - (pivot_pos + 1);
+        if (l_size < size / 8 || r_size < size / 8) {
+            if (--bad_allowed == 0) {
+                heap_sort(a, begin, end, cmp);
+                return;
+            }
+            break_patterns(a, begin, pivot_pos);
+            break_patterns(a, pivot_pos + 1, end);
+        } else if (already && partial_insertion_sort(a, begin, pivot_pos, cmp)
+                && partial_insertion_sort(a, pivot_pos + 1, end, cmp)) {
+            return;
+        }
+
+        if (l_size < r_size) {
+            pdq_sort(a, begin, pivot_pos, bad_allowed, leftmost, cmp);
+            begin = pivot_pos + 1;
+            leftmost = 0;
+        } else {
+            pdq_sort(a, pivot_pos + 1, end, bad_allowed, 0, cmp);
+            end = pivot_pos;
         }
     }
-    swap(&a[i + 1], &a[right]);
-    return i + 1;
 }
 
 /*
- * Recursive quick sort implementation that uses the provided comparison function.
+ * Sort a[left..right] with pdq_sort, allowing about log2(n) bad partitions.
  */
 static void quick_sort_with_cmp(void *a[], int left, int right, int (*cmp)(void*, void*)) {
     if (left < right) {
-        int pivot_index = partition(a, left, right, cmp);
-        quick_sort_with_cmp(a, left, pivot_index - 1, cmp);
-        quick_sort_with_cmp(a, pivot_index + 1, right, cmp);
+        int bad_allowed = 1;
+        for (int n = right - left + 1; n > 1; n >>= 1)
+            bad_allowed++;
+        pdq_sort(a, left, right + 1, bad_allowed, 1, cmp);
     }
 }
 
@@ -76,15 +300,309 @@ void select_sort(void *a[], int left, int right) {
 }
 
 /*
- * Implementation of quick sort using the default comparison function.
+ * Implementation of quick sort (pdqsort) using the default comparison function.
  */
 void quick_sort(void *a[], int left, int right) {
     quick_sort_with_cmp(a, left, right, default_compare);
 }
 
 /*
- * Generic sort function that uses quick sort with the caller-supplied comparison function.
+ * Generic sort function that uses quick sort (pdqsort) with the caller-supplied comparison function.
  */
 void my_sort(void *a[], int left, int right, int (*cmp)(void*, void*)) {
     quick_sort_with_cmp(a, left, right, cmp);
 }
+
+static int parallel_threshold = PARALLEL_SORT_THRESHOLD;
+
+void my_sort_parallel_threshold(int n) {
+    parallel_threshold = (n > 0) ? n : PARALLEL_SORT_THRESHOLD;
+}
+
+/*
+ * Co-rank for a stable merge of A[0..m-1] and B[0..n-1], elements of A
+ * first on ties: the number i of elements of A among the first k outputs.
+ * It is the smallest i with B[k-i-1] < A[i], found by binary search, so
+ * that each thread can start merging in the middle of the output.
+ */
+static int co_rank(int k, void **A, int m, void **B, int n, int (*cmp)(void*, void*)) {
+    int lo = (k > n) ? k - n : 0;
+    int hi = (k < m) ? k : m;
+    while (lo < hi) {
+        int i = lo + (hi - lo) / 2;
+        int j = k - i;
+        if (j > 0 && cmp(B[j - 1], A[i]) >= 0)
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+/*
+ * State of one phase of my_sort_parallel(): the sorted runs of src that
+ * are merged pairwise into dst, or with copy set, a plain copy of src.
+ */
+typedef struct {
+    void **src, **dst;
+    int *runs;     /* run r is src[runs[r]..runs[r+1]-1] */
+    int nruns;
+    int copy;
+    int n;
+    int (*cmp)(void*, void*);
+} SORTPHASE;
+
+typedef struct {
+    SORTPHASE *phase;
+    int begin, end;   /* output slice of this worker */
+} SORTSLICE;
+
+/*
+ * Produce dst[begin..end-1]: every pair of runs overlapping the slice is
+ * merged from the co-ranks of the slice ends, a last unpaired run copied.
+ */
+static void *sort_slice(void *arg) {
+    SORTSLICE *slice = (SORTSLICE *)arg;
+    SORTPHASE *ph = slice->phase;
+    if (ph->copy) {
+        memcpy(ph->dst + slice->begin, ph->src + slice->begin,
+                (size_t)(slice->end - slice->begin) * sizeof(void *));
+        return NULL;
+    }
+    for (int r = 0; r < ph->nruns; r += 2) {
+        int ps = ph->runs[r];
+        int pm = ph->runs[r + 1];
+        int pe = (r + 2 <= ph->nruns) ? ph->runs[r + 2] : pm;
+        int s = slice->begin > ps ? slice->begin : ps;
+        int e = slice->end < pe ? slice->end : pe;
+        if (s >= e)
+            continue;
+        void **A = ph->src + ps, **B = ph->src + pm;
+        int m = pm - ps, n = pe - pm;
+        int i = co_rank(s - ps, A, m, B, n, ph->cmp), j = s - ps - i;
+        int i_end = co_rank(e - ps, A, m, B, n, ph->cmp), j_end = e - ps - i_end;
+        void **out = ph->dst + s;
+        while (i < i_end && j < j_end) {
+            if (ph->cmp(B[j], A[i]) < 0)
+                *out++ = B[j++];
+            else
+                *out++ = A[i++];
+        }
+        while (i < i_end)
+            *out++ = A[i++];
+        while (j < j_end)
+            *out++ = B[j++];
+    }
+    return NULL;
+}
+
+/*
+ * Sort one run of the initial split with the serial sort.
+ */
+static void *sort_run(void *arg) {
+    SORTSLICE *slice = (SORTSLICE *)arg;
+    quick_sort_with_cmp(slice->phase->src, slice->begin, slice->end - 1, slice->phase->cmp);
+    return NULL;
+}
+
+/*
+ * Run fn on slices[0..nthreads-1], slice 0 on the calling thread; slices
+ * whose thread cannot be created are run inline.
+ */
+static void run_slices(void *(*fn)(void *), SORTSLICE *slices, pthread_t *threads, int nthreads) {
+    int started = 1;
+    while (started < nthreads && pthread_create(&threads[started], NULL, fn, &slices[started]) == 0)
+        started++;
+    for (int i = started; i < nthreads; i++)
+        fn(&slices[i]);
+    fn(&slices[0]);
+    for (int i = 1; i < started; i++)
+        pthread_join(threads[i], NULL);
+}
+
+/*
+ * Parallel merge sort: nthreads runs are sorted by the serial sort in
+ * parallel, then merged pairwise in rounds. Each round cuts the output into
+ * nthreads equal slices, so all threads stay busy down to the last merge.
+ */
+void my_sort_parallel(void *a[], int left, int right, int (*cmp)(void*, void*), int nthreads) {
+    int n = right - left + 1;
+    if (nthreads <= 0)
+        nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads > n / 1024)
+        nthreads = n / 1024;
+    if (n < parallel_threshold || nthreads <= 1) {
+        quick_sort_with_cmp(a, left, right, cmp);
+        return;
+    }
+    void **tmp = (void **)malloc((size_t)n * sizeof(void *));
+    int *runs = (int *)malloc((nthreads + 1) * sizeof(int));
+    SORTSLICE *slices = (SORTSLICE *)malloc(nthreads * sizeof(SORTSLICE));
+    pthread_t *threads = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+    if (tmp == NULL || runs == NULL || slices == NULL || threads == NULL) {
+        free(tmp);
+        free(runs);
+        free(slices);
+        free(threads);
+        quick_sort_with_cmp(a, left, right, cmp);
+        return;
+    }
+
+    SORTPHASE ph = { a + left, tmp, runs, nthreads, 0, n, cmp };
+    for (int t = 0; t <= nthreads; t++)
+        runs[t] = (int)((long long)n * t / nthreads);
+    // the initial runs are also the output slices of every merge round
+    for (int t = 0; t < nthreads; t++) {
+        slices[t].phase = &ph;
+        slices[t].begin = runs[t];
+        slices[t].end = runs[t + 1];
+    }
+    run_slices(sort_run, slices, threads, nthreads);
+
+    while (ph.nruns > 1) {
+        run_slices(sort_slice, slices, threads, nthreads);
+        int k = 0;
+        for (int r = 0; r < ph.nruns; r += 2)
+            runs[k++] = runs[r];
+        runs[k] = n;
+        ph.nruns = k;
+        void **t = ph.src;
+        ph.src = ph.dst;
+        ph.dst = t;
+    }
+    if (ph.src != a + left) {
+        ph.dst = a + left;
+        ph.copy = 1;
+        run_slices(sort_slice, slices, threads, nthreads);
+    }
+    free(tmp);
+    free(runs);
+    free(slices);
+    free(threads);
+}
+
+/*
+ * Flip all bits of a negative number, only the sign bit of a positive one.
+ */
+unsigned float_key(float f) {
+    unsigned u;
+    memcpy(&u, &f, sizeof u);
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+float key_float(unsigned u) {
+    u = (u & 0x80000000u) ? (u & 0x7fffffffu) : ~u;
+    float f;
+    memcpy(&f, &u, sizeof f);
+    return f;
+}
+
+/*
+ * Stable LSD radix sort of n (key, index) pairs packed as key << 32 | index,
+ * RADIX_BITS of the key per pass. All histograms are counted in one pass,
+ * and a pass is skipped when every key has the same digit there.
+ * Returns the array that holds the result, a or tmp.
+ */
+static unsigned long long *radix_sort_pairs(unsigned long long *a, unsigned long long *tmp, int n) {
+    if (n < RADIX_SORT_THRESHOLD) {
+        for (int i = 1; i < n; i++) {
+            unsigned long long t = a[i];
+            int j = i;
+            for (; j > 0 && (a[j - 1] >> 32) > (t >> 32); j--)
+                a[j] = a[j - 1];
+            a[j] = t;
+        }
+        return a;
+    }
+    enum { BUCKETS = 1 << RADIX_BITS, PASSES = (32 + RADIX_BITS - 1) / RADIX_BITS };
+    int *count = (int *)calloc(PASSES * BUCKETS, sizeof(int));
+    if (count == NULL) {
+        fprintf(stderr, "Memory allocation failed in radix sort\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        unsigned k = (unsigned)(a[i] >> 32);
+        for (int pass = 0; pass < PASSES; pass++)
+            count[pass * BUCKETS + ((k >> (RADIX_BITS * pass)) & (BUCKETS - 1))]++;
+    }
+    for (int pass = 0; pass < PASSES; pass++) {
+        int *c = count + BUCKETS * pass;
+        int shift = 32 + RADIX_BITS * pass;
+        if (c[(a[0] >> shift) & (BUCKETS - 1)] == n)
+            continue;
+        for (int b = 0, sum = 0; b < BUCKETS; b++) {
+            int t = c[b];
+            c[b] = sum;
+            sum += t;
+        }
+        for (int i = 0; i < n; i++)
+            tmp[c[(a[i] >> shift) & (BUCKETS - 1)]++] = a[i];
+        unsigned long long *t = a;
+        a = tmp;
+        tmp = t;
+    }
+    free(count);
+    return a;
+}
+
+/*
+ * Allocate room for n pairs and as many for the radix sort to work in.
+ */
+static unsigned long long *pair_buffer(int n) {
+    unsigned long long *a = (unsigned long long *)malloc(2 * (size_t)n * sizeof(unsigned long long));
+    if (a == NULL) {
+        fprintf(stderr, "Memory allocation failed in radix sort\n");
+        exit(EXIT_FAILURE);
+    }
+    return a;
+}
+
+void sort_float_keys(float *keys, int *index, int n, int descending) {
+    if (keys == NULL || n < 2)
+        return;
+    unsigned flip = descending ? 0xffffffffu : 0;
+    unsigned long long *a = pair_buffer(n);
+    for (int i = 0; i < n; i++) {
+        unsigned position = index != NULL ? (unsigned)index[i] : (unsigned)i;
+        a[i] = (unsigned long long)(float_key(keys[i]) ^ flip) << 32 | position;
+    }
+    unsigned long long *r = radix_sort_pairs(a, a + n, n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = key_float((unsigned)(r[i] >> 32) ^ flip);
+        if (index != NULL)
+            index[i] = (int)(unsigned)r[i];
+    }
+    free(a);
+}
+
+void sort_int_keys(int *keys, int *index, int n, int descending) {
+    if (keys == NULL || n < 2)
+        return;
+    unsigned flip = descending ? 0x7fffffffu : 0x80000000u;
+    unsigned long long *a = pair_buffer(n);
+    for (int i = 0; i < n; i++) {
+        unsigned position = index != NULL ? (unsigned)index[i] : (unsigned)i;
+        a[i] = (unsigned long long)((unsigned)keys[i] ^ flip) << 32 | position;
+    }
+    unsigned long long *r = radix_sort_pairs(a, a + n, n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = (int)((unsigned)(r[i] >> 32) ^ flip);
+        if (index != NULL)
+            index[i] = (int)(unsigned)r[i];
+    }
+    free(a);
+}
+
+void permute(void *base, int n, size_t size, const int *index) {
+    if (base == NULL || index == NULL || n < 2)
+        return;
+    char *copy = (char *)malloc((size_t)n * size);
+    if (copy == NULL) {
+        fprintf(stderr, "Memory allocation failed in permute()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++)
+        memcpy(copy + (size_t)i * size, (char *)base + (size_t)index[i] * size, size);
+    memcpy(base, copy, (size_t)n * size);
+    free(copy);
+}
@@ -1,6 +1,8 @@
 #ifndef MYSORT_H
 #define MYSORT_H
 
+#include <stddef.h>
+
 /**
  * Use selection sort algorithm to sort an array of pointers such that their pointed values 
  * are in increasing order. (Assumes that the pointers refer to integers.)
@@ -34,4 +36,68 @@ void quick_sort(void *a[], int left, int right);
  */
 void my_sort(void *a[], int left, int right, int (*cmp)(void*, void*));
 
+#define PARALLEL_SORT_THRESHOLD 100000   /* default shortest array sorted in parallel */
+
+/**
+ * Sort as my_sort() does, with the same comparison function contract, using
+ * several threads: the array is cut into nthreads runs that are sorted in
+ * parallel, and the runs are merged pairwise with every merge round split
+ * evenly across the threads. Equal elements of different runs keep their
+ * run order, but the runs themselves are sorted by the unstable my_sort().
+ * Arrays shorter than the threshold are sorted by my_sort().
+ *
+ * @param a[]  Array of void pointers.
+ * @param left The starting index in the array.
+ * @param right The ending index in the array.
+ * @param cmp  Pointer to a comparison function, as for my_sort().
+ * @param nthreads Number of threads, or 0 for the number of online processors.
+ */
+void my_sort_parallel(void *a[], int left, int right, int (*cmp)(void*, void*), int nthreads);
+
+/**
+ * Set the shortest array that my_sort_parallel() sorts in parallel.
+ *
+ * @param n The threshold, or 0 to restore PARALLEL_SORT_THRESHOLD.
+ */
+void my_sort_parallel_threshold(int n);
+
+/**
+ * Sort an array of float keys with an LSD radix sort, 11 bits per pass,
+ * skipping passes where all keys share the digit, and carry an int
+ * alongside each key. The sort is stable: equal keys keep their
+ * input order, also when sorting in decreasing order. Comparisons are on the
+ * keys themselves, so there are no function calls or pointer dereferences
+ * per element. To sort records, fill keys with their scores and index with
+ * 0..n-1; index then is the sorted order of the records (see permute()).
+ *
+ * @param keys  Array of n keys, sorted in place.
+ * @param index Array of n values moved with the keys, or NULL.
+ * @param n     Number of keys.
+ * @param descending 1 to sort in decreasing order, 0 for increasing order.
+ */
+void sort_float_keys(float *keys, int *index, int n, int descending);
+
+/**
+ * Sort an array of int keys, as sort_float_keys() does.
+ */
+void sort_int_keys(int *keys, int *index, int n, int descending);
+
+/**
+ * Map a float to an unsigned key with the same order, the order
+ * sort_float_keys() sorts by; key_float() maps the key back.
+ */
+unsigned float_key(float f);
+float key_float(unsigned u);
+
+/**
+ * Rearrange an array of n elements of the given size so that element i
+ * becomes the element that was at position index[i].
+ *
+ * @param base  The array.
+ * @param n     Number of elements.
+ * @param size  Size of an element in bytes.
+ * @param index A permutation of 0..n-1, e.g. from sort_float_keys().
+ */
+void permute(void *base, int n, size_t size, const int *index);
+
 #endif /* MYSORT_H */
@@ -12,6 +12,7 @@ Version: 2025-01-28
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
 #include "mysort.h"
 
 #define FLOATFORMAT "%.0f"
@@ -118,6 +119,248 @@ void test_my_sort() {
 }
 
 
+static const char *patterns[] = { "random", "sorted", "reversed", "organ-pipe", "few-unique" };
+
+/*
+ * Fill d[0..n-1] with the given input pattern.
+ */
+void fill_pattern(float d[], int n, int pattern) {
+	for (int i = 0; i < n; i++) {
+		switch (pattern) {
+		case 0: d[i] = rand() % n; break;
+		case 1: d[i] = i; break;
+		case 2: d[i] = n - i; break;
+		case 3: d[i] = (i < n / 2) ? i : n - i; break;
+		default: d[i] = rand() % 4; break;
+		}
+	}
+}
+
+static long comparisons;
+
+int count_cmp(void *x, void *y) {
+	comparisons++;
+	float a = *(float*)x;
+	float b = *(float*)y;
+	return (a > b) - (a < b);
+}
+
+/*
+ * Comparator without the shared counter, for the threads of my_sort_parallel.
+ */
+int float_cmp(void *x, void *y) {
+	float a = *(float*)x;
+	float b = *(float*)y;
+	return (a > b) - (a < b);
+}
+
+int is_sorted(float *a[], int n) {
+	for (int i = 1; i < n; i++) {
+		if (*a[i] < *a[i - 1])
+			return 0;
+	}
+	return 1;
+}
+
+void test_my_sort_patterns() {
+	printf("------------------\n");
+	printf("Test: my_sort patterns\n\n");
+	int n = 5000;
+	float *d = malloc(n * sizeof(float));
+	float **a = malloc(n * sizeof(float*));
+	srand(1);
+	int npatterns = (int) (sizeof patterns / sizeof *patterns);
+	for (int p = 0; p < npatterns; p++) {
+		fill_pattern(d, n, p);
+		copy_data_address(d, a, 0, n - 1);
+		my_sort((void*) a, 0, n - 1, count_cmp);
+		printf("my_sort(%s, %d): sorted %d\n", patterns[p], n, is_sorted(a, n));
+	}
+	free(a);
+	free(d);
+	printf("\n");
+}
+
+/*
+ * Time my_sort against the C library qsort on n elements of each pattern.
+ */
+int qsort_cmp(const void *x, const void *y) {
+	comparisons++;
+	float a = **(float**)x;
+	float b = **(float**)y;
+	return (a > b) - (a < b);
+}
+
+void time_test_patterns(int n) {
+	printf("------------------\n");
+	printf("Test: sorting time by input pattern, %d numbers\n\n", n);
+	float *d = malloc(n * sizeof(float));
+	float **a = malloc(n * sizeof(float*));
+	int npatterns = (int) (sizeof patterns / sizeof *patterns);
+	for (int p = 0; p < npatterns; p++) {
+		fill_pattern(d, n, p);
+		copy_data_address(d, a, 0, n - 1);
+		comparisons = 0;
+		clock_t t1 = clock();
+		my_sort((void*) a, 0, n - 1, count_cmp);
+		double s1 = (double) (clock() - t1) / CLOCKS_PER_SEC;
+		long c1 = comparisons;
+		int sorted = is_sorted(a, n);
+
+		copy_data_address(d, a, 0, n - 1);
+		comparisons = 0;
+		t1 = clock();
+		qsort(a, n, sizeof(float*), qsort_cmp);
+		double s2 = (double) (clock() - t1) / CLOCKS_PER_SEC;
+		printf("%-10s my_sort: %0.3f (s), %10ld cmps, sorted %d;  qsort: %0.3f (s), %10ld cmps\n",
+				patterns[p], s1, c1, sorted, s2, comparisons);
+	}
+	free(a);
+	free(d);
+	printf("\n");
+}
+
+void test_sort_keys() {
+	printf("------------------\n");
+	printf("Test: sort_float_keys, sort_int_keys\n\n");
+	float keys[] = { 3.5, -1, 4, 1, 5, -9.25, 2, 6, 4, 3.5 };
+	int ikeys[] = { 3, -1, 4, 1, -5, 9, 2, 6, 5, 3 };
+	int n = sizeof keys / sizeof *keys;
+	int index[10];
+	for (int descending = 0; descending <= 1; descending++) {
+		float k[10];
+		for (int i = 0; i < n; i++) {
+			k[i] = keys[i];
+			index[i] = i;
+		}
+		sort_float_keys(k, index, n, descending);
+		printf("sort_float_keys(%s):", descending ? "decreasing" : "increasing");
+		for (int i = 0; i < n; i++) {
+			printf(" %g@%d", k[i], index[i]);
+		}
+		printf("\n");
+	}
+	sort_int_keys(ikeys, NULL, n, 0);
+	printf("sort_int_keys(increasing):");
+	for (int i = 0; i < n; i++) {
+		printf(" %d", ikeys[i]);
+	}
+	printf("\n\n");
+}
+
+void test_my_sort_parallel() {
+	printf("------------------\n");
+	printf("Test: my_sort_parallel\n\n");
+	int n = 200000;
+	float *d = malloc(n * sizeof(float));
+	float **a = malloc(n * sizeof(float*));
+	srand(1);
+	int npatterns = (int) (sizeof patterns / sizeof *patterns);
+	for (int p = 0; p < npatterns; p++) {
+		fill_pattern(d, n, p);
+		copy_data_address(d, a, 0, n - 1);
+		my_sort_parallel((void*) a, 0, n - 1, float_cmp, 4);
+		printf("my_sort_parallel(%s, %d, 4 threads): sorted %d\n", patterns[p], n, is_sorted(a, n));
+	}
+	free(a);
+	free(d);
+	printf("\n");
+}
+
+double wall_time() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Time my_sort_parallel on n random numbers from 1 thread up to one per
+ * online processor.
+ */
+void time_test_parallel(int n) {
+	int cores = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	printf("------------------\n");
+	printf("Test: my_sort_parallel scaling, %d numbers, %d core(s)\n\n", n, cores);
+	float *d = malloc(n * sizeof(float));
+	float **a = malloc(n * sizeof(float*));
+	fill_pattern(d, n, 0);
+	double base = 0;
+	for (int t = 1; ; t = (2 * t < cores) ? 2 * t : cores) {
+		copy_data_address(d, a, 0, n - 1);
+		double t1 = wall_time();
+		my_sort_parallel((void*) a, 0, n - 1, float_cmp, t);
+		double s = wall_time() - t1;
+		if (t == 1)
+			base = s;
+		printf("%2d thread(s): %0.3f (s), speedup %0.2f, sorted %d\n", t, s, base / s, is_sorted(a, n));
+		if (t >= cores)
+			break;
+	}
+	free(a);
+	free(d);
+	printf("\n");
+}
+
+typedef struct {
+	char name[21];
+	float score;
+} ITEM;
+
+int item_cmp(void *x, void *y) {
+	float a = ((ITEM*) x)->score;
+	float b = ((ITEM*) y)->score;
+	return (a > b) - (a < b);
+}
+
+/*
+ * Sort n records by score with my_sort on pointers, and with
+ * sort_float_keys on the extracted scores followed by permute.
+ */
+void time_test_keys(int n) {
+	printf("------------------\n");
+	printf("Test: sorting %d records by score\n\n", n);
+	ITEM *items = malloc(n * sizeof(ITEM));
+	ITEM **p = malloc(n * sizeof(ITEM*));
+	float *keys = malloc(n * sizeof(float));
+	int *index = malloc(n * sizeof(int));
+	for (int i = 0; i < n; i++) {
+		sprintf(items[i].name, "R%d", i);
+		items[i].score = (rand() % 1000000) / 10000.0;
+	}
+	clock_t t1 = clock();
+	for (int i = 0; i < n; i++) {
+		p[i] = &items[i];
+	}
+	my_sort((void*) p, 0, n - 1, item_cmp);
+	double s1 = (double) (clock() - t1) / CLOCKS_PER_SEC;
+
+	t1 = clock();
+	for (int i = 0; i < n; i++) {
+		keys[i] = items[i].score;
+		index[i] = i;
+	}
+	sort_float_keys(keys, index, n, 0);
+	double s2 = (double) (clock() - t1) / CLOCKS_PER_SEC;
+	int same = 1;
+	for (int i = 0; i < n; i++) {
+		same = same && p[i]->score == keys[i];
+	}
+	t1 = clock();
+	permute(items, n, sizeof(ITEM), index);
+	double s3 = s2 + (double) (clock() - t1) / CLOCKS_PER_SEC;
+	for (int i = 0; i < n; i++) {
+		same = same && items[i].score == keys[i];
+	}
+	printf("my_sort pointers:      %0.3f (s)\n", s1);
+	printf("sort_float_keys:       %0.3f (s), speedup %0.1f\n", s2, s1 / s2);
+	printf("sort_float_keys+permute: %0.3f (s), speedup %0.1f, same order: %d\n", s3, s1 / s3, same);
+	free(items);
+	free(p);
+	free(keys);
+	free(index);
+	printf("\n");
+}
+
 void time_test_sort() {
 	printf("------------------\n");
 	printf("Test: sorting time and comparison\n\n");
@@ -167,8 +410,15 @@ int main(int argc, char *args[])
 	  test_select_sort();
 	  test_quick_sort();
 	  test_my_sort();
+	  test_my_sort_patterns();
+	  test_sort_keys();
+	  test_my_sort_parallel();
 	} else {
 		time_test_sort();
+		int n = atoi(args[1]);
+		time_test_patterns(n > 0 ? n : 1000000);
+		time_test_keys(n > 0 ? n : 1000000);
+		time_test_parallel(n > 0 ? n : 1000000);
 	}
 	return 0;
 } 
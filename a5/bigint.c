@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <string.h>
 
 /*
  * Creates a BIGINT from the given digit string.
@@ -22,6 +23,8 @@ BIGINT bigint(char *digitstr) {
     }
     b->length = 0;
     b->start = b->end = NULL;
+    b->pool = NULL;
+    dll_pool_init(b, strlen(digitstr));
     
     // Process each character in the string
     for (int i = 0; digitstr[i] != '\0'; i++) {
@@ -31,7 +34,7 @@ BIGINT bigint(char *digitstr) {
             continue;
         }
         // Create a new node for this digit
-        NODE *node = dll_node(ch);
+        NODE *node = dll_pool_node(b, ch);
         // Insert at the end so that the order of digits is preserved.
         dll_insert_end(b, node);
     }
@@ -52,6 +55,8 @@ BIGINT bigint_add(BIGINT op1, BIGINT op2) {
     }
     result->length = 0;
     result->start = result->end = NULL;
+    result->pool = NULL;
+    dll_pool_init(result, (op1->length > op2->length ? op1->length : op2->length) + 1);
     
     NODE *p1 = op1->end;  // pointer to least significant digit of operand1
     NODE *p2 = op2->end;  // pointer to least significant digit of operand2
@@ -65,7 +70,7 @@ BIGINT bigint_add(BIGINT op1, BIGINT op2) {
         carry = sum / 10;
         
         // Create a node for the resulting digit.
-        NODE *node = dll_node((char)(digit + '0'));
+        NODE *node = dll_pool_node(result, (char)(digit + '0'));
         // Since we are adding from the least significant end,
         // insert each new digit at the start to obtain the proper order.
         dll_insert_start(result, node);
@@ -81,28 +86,669 @@ BIGINT bigint_add(BIGINT op1, BIGINT op2) {
  * Computes and returns Fibonacci(n) as a BIGINT.
  * For n <= 0, returns BIGINT representing 0.
  * For n = 1 or n = 2, returns BIGINT representing 1.
- * Uses an iterative algorithm with BIGINT addition.
+ * The sequence is computed with in-place BIGNUM additions and converted
+ * to the digit list once at the end.
  */
 BIGINT bigint_fibonacci(int n) {
-    if (n <= 0) {
-        return bigint("0");
+    BIGNUM f = bignum_fibonacci(n);
+    BIGINT result = bignum_to_bigint(&f);
+    bignum_clean(&f);
+    return result;
+}
+
+static int karatsuba_threshold = KARATSUBA_THRESHOLD;
+static int toom3_threshold = TOOM3_THRESHOLD;
+
+/*
+ * Make sure a has room for capacity limbs.
+ */
+static void bignum_reserve(BIGNUM *a, int capacity) {
+    if (capacity <= a->capacity)
+        return;
+    if (capacity < 2 * a->capacity)
+        capacity = 2 * a->capacity;
+    unsigned int *limb = (unsigned int *)realloc(a->limb, capacity * sizeof(unsigned int));
+    if (limb == NULL) {
+        fprintf(stderr, "Memory allocation failed in bignum_reserve()\n");
+        exit(EXIT_FAILURE);
+    }
+    a->limb = limb;
+    a->capacity = capacity;
+}
+
+/*
+ * Drop high zero limbs so that size 0 means zero, which is never negative.
+ */
+static void bignum_normalize(BIGNUM *a) {
+    while (a->size > 0 && a->limb[a->size - 1] == 0)
+        a->size--;
+    if (a->size == 0)
+        a->negative = 0;
+}
+
+/*
+ * Return a zero BIGNUM with room for capacity limbs.
+ */
+static BIGNUM bignum_new(int capacity) {
+    BIGNUM a = { 0, 0, NULL, 0 };
+    bignum_reserve(&a, capacity > 0 ? capacity : 1);
+    return a;
+}
+
+static BIGNUM bignum_copy(BIGNUM *a) {
+    BIGNUM c = bignum_new(a->size + 1);
+    if (a->size > 0)
+        memcpy(c.limb, a->limb, a->size * sizeof(unsigned int));
+    c.size = a->size;
+    c.negative = a->negative;
+    return c;
+}
+
+/*
+ * Parse the digits from the least significant end, nine per limb.
+ */
+BIGNUM bignum(char *digitstr) {
+    BIGNUM a = { 0, 0, NULL, 0 };
+    if (digitstr == NULL)
+        return a;
+
+    int len = strlen(digitstr);
+    bignum_reserve(&a, len / BIGNUM_DIGITS + 1);
+    unsigned int limb = 0, scale = 1;
+    int digits = 0;
+    for (int i = len - 1; i >= 0; i--) {
+        if (!isdigit((unsigned char)digitstr[i]))
+            continue;
+        limb += (digitstr[i] - '0') * scale;
+        scale *= 10;
+        if (++digits == BIGNUM_DIGITS) {
+            a.limb[a.size++] = limb;
+            limb = 0;
+            scale = 1;
+            digits = 0;
+        }
     }
-    if (n == 1 || n == 2) {
-        return bigint("1");
+    if (digits > 0)
+        a.limb[a.size++] = limb;
+    while (isspace((unsigned char)*digitstr))
+        digitstr++;
+    a.negative = (*digitstr == '-');
+    bignum_normalize(&a);
+    return a;
+}
+
+/*
+ * Limb array helpers on magnitudes, least significant limb first.
+ * The result array may alias an operand: every limb is read before it
+ * is written at the same index.
+ */
+static int cmp_mag(unsigned int *a, int an, unsigned int *b, int bn) {
+    if (an != bn)
+        return (an > bn) ? 1 : -1;
+    for (int i = an - 1; i >= 0; i--) {
+        if (a[i] != b[i])
+            return (a[i] > b[i]) ? 1 : -1;
     }
-    
-    BIGINT f1 = bigint("1");
-    BIGINT f2 = bigint("1");
-    BIGINT sum = NULL;
-    
-    for (int i = 3; i <= n; i++) {
-        sum = bigint_add(f1, f2);
-        // Clean up f1 before reassigning to avoid memory leaks.
-        dll_clean(f1);
-        free(f1);
+    return 0;
+}
+
+// r = a + b, r has room for max(an, bn) + 1 limbs; returns the size of r
+static int add_mag(unsigned int *r, unsigned int *a, int an, unsigned int *b, int bn) {
+    if (an < bn) {
+        unsigned int *t = a;
+        a = b;
+        b = t;
+        int tn = an;
+        an = bn;
+        bn = tn;
+    }
+    unsigned int carry = 0;
+    int i = 0;
+    for (; i < bn; i++) {
+        unsigned int sum = a[i] + b[i] + carry;
+        carry = (sum >= BIGNUM_BASE);
+        r[i] = carry ? sum - BIGNUM_BASE : sum;
+    }
+    for (; i < an; i++) {
+        unsigned int sum = a[i] + carry;
+        carry = (sum >= BIGNUM_BASE);
+        r[i] = carry ? sum - BIGNUM_BASE : sum;
+    }
+    r[an] = carry;
+    return an + carry;
+}
+
+// r = a - b for |a| >= |b|, r has room for an limbs; returns the size of r
+static int sub_mag(unsigned int *r, unsigned int *a, int an, unsigned int *b, int bn) {
+    int borrow = 0;
+    int i = 0;
+    for (; i < bn; i++) {
+        int d = (int)a[i] - (int)b[i] - borrow;
+        borrow = (d < 0);
+        r[i] = borrow ? d + BIGNUM_BASE : d;
+    }
+    for (; i < an; i++) {
+        int d = (int)a[i] - borrow;
+        borrow = (d < 0);
+        r[i] = borrow ? d + BIGNUM_BASE : d;
+    }
+    while (an > 0 && r[an - 1] == 0)
+        an--;
+    return an;
+}
+
+// r[0..rn) += a[0..an), an <= rn, the carry stops at r[rn-1]
+static void add_into(unsigned int *r, int rn, unsigned int *a, int an) {
+    unsigned int carry = 0;
+    int i = 0;
+    for (; i < an; i++) {
+        unsigned int sum = r[i] + a[i] + carry;
+        carry = (sum >= BIGNUM_BASE);
+        r[i] = carry ? sum - BIGNUM_BASE : sum;
+    }
+    for (; carry && i < rn; i++) {
+        unsigned int sum = r[i] + 1;
+        carry = (sum >= BIGNUM_BASE);
+        r[i] = carry ? 0 : sum;
+    }
+}
+
+// q = a / d, returns a mod d; q may alias a
+static unsigned int div_small_mag(unsigned int *q, unsigned int *a, int an, unsigned int d) {
+    unsigned long long rem = 0;
+    for (int i = an - 1; i >= 0; i--) {
+        unsigned long long cur = rem * BIGNUM_BASE + a[i];
+        q[i] = (unsigned int)(cur / d);
+        rem = cur % d;
+    }
+    return (unsigned int)rem;
+}
+
+int bignum_cmp(BIGNUM *op1, BIGNUM *op2) {
+    if (op1->negative != op2->negative)
+        return op1->negative ? -1 : 1;
+    int c = cmp_mag(op1->limb, op1->size, op2->limb, op2->size);
+    return op1->negative ? -c : c;
+}
+
+/*
+ * Signed addition in place: add magnitudes for equal signs, otherwise
+ * subtract the smaller magnitude from the larger one.
+ */
+void bignum_add_to(BIGNUM *acc, BIGNUM *op) {
+    int n = (acc->size > op->size) ? acc->size : op->size;
+    bignum_reserve(acc, n + 1);   // may move op->limb too when op == acc
+    if (acc->negative == op->negative) {
+        acc->size = add_mag(acc->limb, acc->limb, acc->size, op->limb, op->size);
+    } else if (cmp_mag(acc->limb, acc->size, op->limb, op->size) >= 0) {
+        acc->size = sub_mag(acc->limb, acc->limb, acc->size, op->limb, op->size);
+    } else {
+        acc->size = sub_mag(acc->limb, op->limb, op->size, acc->limb, acc->size);
+        acc->negative = op->negative;
+    }
+    bignum_normalize(acc);
+}
+
+BIGNUM bignum_add(BIGNUM *op1, BIGNUM *op2) {
+    BIGNUM sum = bignum_copy(op1);
+    bignum_add_to(&sum, op2);
+    return sum;
+}
+
+BIGNUM bignum_sub(BIGNUM *op1, BIGNUM *op2) {
+    BIGNUM diff = bignum_copy(op1);
+    BIGNUM neg = *op2;
+    neg.negative = (op2->size > 0) ? !op2->negative : 0;
+    bignum_add_to(&diff, &neg);
+    return diff;
+}
+
+static void mul_limbs(unsigned int *r, unsigned int *a, int an, unsigned int *b, int bn);
+
+/*
+ * Schoolbook product r[0..an+bn) = a * b, one row per limb of a.
+ */
+static void mul_school(unsigned int *r, unsigned int *a, int an, unsigned int *b, int bn) {
+    memset(r, 0, (an + bn) * sizeof(unsigned int));
+    for (int i = 0; i < an; i++) {
+        unsigned long long carry = 0, ai = a[i];
+        for (int j = 0; j < bn; j++) {
+            unsigned long long t = ai * b[j] + r[i + j] + carry;
+            r[i + j] = (unsigned int)(t % BIGNUM_BASE);
+            carry = t / BIGNUM_BASE;
+        }
+        r[i + bn] = (unsigned int)carry;
+    }
+}
+
+/*
+ * Karatsuba product for (an+1)/2 < bn <= an: with x = BASE^h,
+ * a*b = z2*x^2 + ((a0+a1)(b0+b1) - z0 - z2)*x + z0.
+ */
+static void mul_karatsuba(unsigned int *r, unsigned int *a, int an, unsigned int *b, int bn) {
+    int h = (an + 1) / 2;
+    unsigned int *t = (unsigned int *)malloc((4 * h + 4) * sizeof(unsigned int));
+    if (t == NULL) {
+        fprintf(stderr, "Memory allocation failed in mul_karatsuba()\n");
+        exit(EXIT_FAILURE);
+    }
+    unsigned int *sa = t, *sb = t + h + 1, *z1 = t + 2 * h + 2;
+
+    mul_limbs(r, a, h, b, h);                             // z0 in r[0..2h)
+    mul_limbs(r + 2 * h, a + h, an - h, b + h, bn - h);   // z2 in r[2h..an+bn)
+
+    int san = add_mag(sa, a, h, a + h, an - h);
+    int sbn = add_mag(sb, b, h, b + h, bn - h);
+    mul_limbs(z1, sa, san, sb, sbn);
+    int zn = san + sbn;
+    zn = sub_mag(z1, z1, zn, r, 2 * h);
+    zn = sub_mag(z1, z1, zn, r + 2 * h, an + bn - 2 * h);
+    add_into(r + h, an + bn - h, z1, zn);
+    free(t);
+}
+
+/*
+ * Non-owning view of limbs a[off..off+len), clipped to an, normalized.
+ */
+static BIGNUM slice(unsigned int *a, int an, int off, int len) {
+    BIGNUM v = { 0, 0, a + off, 0 };
+    if (off < an)
+        v.size = (off + len <= an) ? len : an - off;
+    while (v.size > 0 && v.limb[v.size - 1] == 0)
+        v.size--;
+    return v;
+}
+
+// exact division of a signed BIGNUM by a small d, in place
+static void bignum_div_exact(BIGNUM *a, unsigned int d) {
+    div_small_mag(a->limb, a->limb, a->size, d);
+    bignum_normalize(a);
+}
+
+/*
+ * Toom-3 product for bn > 2*ceil(an/3): split both operands in three
+ * pieces of k limbs, multiply the evaluations at 0, 1, -1, -2 and
+ * infinity recursively and interpolate (Bodrato's sequence).
+ */
+static void mul_toom3(unsigned int *r, unsigned int *a, int an, unsigned int *b, int bn) {
+    int k = (an + 2) / 3;
+    BIGNUM a0 = slice(a, an, 0, k), a1 = slice(a, an, k, k), a2 = slice(a, an, 2 * k, an);
+    BIGNUM b0 = slice(b, bn, 0, k), b1 = slice(b, bn, k, k), b2 = slice(b, bn, 2 * k, bn);
+
+    // evaluate: p(1) = a0+a1+a2, p(-1) = a0-a1+a2, p(-2) = 2*(p(-1)+a2) - a0
+    BIGNUM t = bignum_add(&a0, &a2);
+    BIGNUM p1 = bignum_add(&t, &a1);
+    BIGNUM pm1 = bignum_sub(&t, &a1);
+    BIGNUM pm2 = bignum_add(&pm1, &a2);
+    bignum_add_to(&pm2, &pm2);
+    BIGNUM u = bignum_sub(&pm2, &a0);
+    bignum_clean(&pm2);
+    pm2 = u;
+    bignum_clean(&t);
+
+    t = bignum_add(&b0, &b2);
+    BIGNUM q1 = bignum_add(&t, &b1);
+    BIGNUM qm1 = bignum_sub(&t, &b1);
+    BIGNUM qm2 = bignum_add(&qm1, &b2);
+    bignum_add_to(&qm2, &qm2);
+    u = bignum_sub(&qm2, &b0);
+    bignum_clean(&qm2);
+    qm2 = u;
+    bignum_clean(&t);
+
+    BIGNUM r0 = bignum_mul(&a0, &b0);
+    BIGNUM r1 = bignum_mul(&p1, &q1);
+    BIGNUM rm1 = bignum_mul(&pm1, &qm1);
+    BIGNUM rm2 = bignum_mul(&pm2, &qm2);
+    BIGNUM rinf = bignum_mul(&a2, &b2);
+
+    // interpolate
+    BIGNUM r3 = bignum_sub(&rm2, &r1);
+    bignum_div_exact(&r3, 3);               // r3 = (rm2 - r1) / 3
+    BIGNUM s = bignum_sub(&r1, &rm1);
+    bignum_div_exact(&s, 2);                // s = (r1 - rm1) / 2
+    BIGNUM r2 = bignum_sub(&rm1, &r0);      // r2 = rm1 - r0
+    t = bignum_sub(&r2, &r3);
+    bignum_div_exact(&t, 2);
+    bignum_add_to(&t, &rinf);
+    bignum_add_to(&t, &rinf);               // r3 = (r2 - r3) / 2 + 2*rinf
+    bignum_clean(&r3);
+    r3 = t;
+    bignum_add_to(&r2, &s);
+    u = bignum_sub(&r2, &rinf);             // r2 = r2 + s - rinf
+    bignum_clean(&r2);
+    r2 = u;
+    u = bignum_sub(&s, &r3);                // r1 = s - r3
+    bignum_clean(&r1);
+    r1 = u;
+
+    // recompose r = r0 + r1*x + r2*x^2 + r3*x^3 + rinf*x^4, all non-negative
+    int rn = an + bn;
+    memset(r, 0, rn * sizeof(unsigned int));
+    add_into(r, rn, r0.limb, r0.size);
+    add_into(r + k, rn - k, r1.limb, r1.size);
+    add_into(r + 2 * k, rn - 2 * k, r2.limb, r2.size);
+    add_into(r + 3 * k, rn - 3 * k, r3.limb, r3.size);
+    add_into(r + 4 * k, rn - 4 * k, rinf.limb, rinf.size);
+
+    BIGNUM *tmp[] = { &p1, &pm1, &pm2, &q1, &qm1, &qm2, &r0, &r1, &rm1, &rm2,
+                      &rinf, &r2, &r3, &s };
+    for (int i = 0; i < (int)(sizeof tmp / sizeof *tmp); i++)
+        bignum_clean(tmp[i]);
+}
+
+/*
+ * r[0..an+bn) = a * b; picks schoolbook, Karatsuba or Toom-3 by size and
+ * cuts very unbalanced operands into bn-limb blocks of a.
+ */
+static void mul_limbs(unsigned int *r, unsigned int *a, int an, unsigned int *b, int bn) {
+    if (an < bn) {
+        unsigned int *t = a;
+        a = b;
+        b = t;
+        int tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn == 0) {
+        memset(r, 0, an * sizeof(unsigned int));
+    } else if (bn < karatsuba_threshold) {
+        mul_school(r, a, an, b, bn);
+    } else if (bn <= (an + 1) / 2) {
+        unsigned int *t = (unsigned int *)malloc(2 * bn * sizeof(unsigned int));
+        if (t == NULL) {
+            fprintf(stderr, "Memory allocation failed in mul_limbs()\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(r, 0, (an + bn) * sizeof(unsigned int));
+        for (int off = 0; off < an; off += bn) {
+            int len = (an - off < bn) ? an - off : bn;
+            mul_limbs(t, a + off, len, b, bn);
+            add_into(r + off, an + bn - off, t, len + bn);
+        }
+        free(t);
+    } else if (bn >= toom3_threshold && bn > 2 * ((an + 2) / 3)) {
+        mul_toom3(r, a, an, b, bn);
+    } else {
+        mul_karatsuba(r, a, an, b, bn);
+    }
+}
+
+BIGNUM bignum_mul(BIGNUM *op1, BIGNUM *op2) {
+    BIGNUM r = bignum_new(op1->size + op2->size);
+    mul_limbs(r.limb, op1->limb, op1->size, op2->limb, op2->size);
+    r.size = op1->size + op2->size;
+    r.negative = op1->negative ^ op2->negative;
+    bignum_normalize(&r);
+    return r;
+}
+
+void bignum_mul_thresholds(int karatsuba, int toom3) {
+    karatsuba_threshold = (karatsuba > 0) ? karatsuba : KARATSUBA_THRESHOLD;
+    toom3_threshold = (toom3 > 0) ? toom3 : TOOM3_THRESHOLD;
+}
+
+unsigned int bignum_divmod_small(BIGNUM *op, unsigned int d, BIGNUM *q) {
+    if (d == 0) {
+        fprintf(stderr, "Division by zero in bignum_divmod_small()\n");
+        return 0;
+    }
+    if (q == NULL) {
+        unsigned long long rem = 0;
+        for (int i = op->size - 1; i >= 0; i--)
+            rem = (rem * BIGNUM_BASE + op->limb[i]) % d;
+        return (unsigned int)rem;
+    }
+    BIGNUM quot = bignum_new(op->size);
+    unsigned int rem = div_small_mag(quot.limb, op->limb, op->size, d);
+    quot.size = op->size;
+    quot.negative = op->negative;
+    bignum_normalize(&quot);
+    *q = quot;
+    return rem;
+}
+
+/*
+ * Knuth's algorithm D in base 10^9: scale both operands so that the top
+ * divisor limb is at least BASE/2, estimate each quotient limb from the
+ * top two limbs, correct it at most twice, multiply and subtract, and
+ * add back in the rare case the estimate was still one too large.
+ */
+static void divmod_knuth(unsigned int *q, unsigned int *u, int un, unsigned int *v, int vn) {
+    unsigned long long base = BIGNUM_BASE;
+    unsigned int f = BIGNUM_BASE / (v[vn - 1] + 1);
+    if (f > 1) {
+        unsigned long long carry = 0;
+        for (int i = 0; i < un; i++) {
+            unsigned long long t = (unsigned long long)u[i] * f + carry;
+            u[i] = (unsigned int)(t % base);
+            carry = t / base;
+        }
+        u[un] = (unsigned int)carry;
+        carry = 0;
+        for (int i = 0; i < vn; i++) {
+            unsigned long long t = (unsigned long long)v[i] * f + carry;
+            v[i] = (unsigned int)(t % base);
+            carry = t / base;
+        }
+    } else {
+        u[un] = 0;
+    }
+
+    for (int j = un - vn; j >= 0; j--) {
+        unsigned long long top = u[j + vn] * base + u[j + vn - 1];
+        unsigned long long qhat = top / v[vn - 1];
+        unsigned long long rhat = top % v[vn - 1];
+        while (qhat >= base || (vn > 1 && qhat * v[vn - 2] > rhat * base + u[j + vn - 2])) {
+            qhat--;
+            rhat += v[vn - 1];
+            if (rhat >= base)
+                break;
+        }
+
+        long long borrow = 0;
+        unsigned long long carry = 0;
+        for (int i = 0; i < vn; i++) {
+            unsigned long long p = qhat * v[i] + carry;
+            carry = p / base;
+            long long t = (long long)u[i + j] - (long long)(p % base) - borrow;
+            borrow = (t < 0);
+            u[i + j] = (unsigned int)(borrow ? t + (long long)base : t);
+        }
+        long long t = (long long)u[j + vn] - (long long)carry - borrow;
+        if (t < 0) {
+            // qhat was one too large: add v back
+            u[j + vn] = (unsigned int)(t + (long long)base);
+            qhat--;
+            unsigned int c = 0;
+            for (int i = 0; i < vn; i++) {
+                unsigned int sum = u[i + j] + v[i] + c;
+                c = (sum >= BIGNUM_BASE);
+                u[i + j] = c ? sum - BIGNUM_BASE : sum;
+            }
+            u[j + vn] = (u[j + vn] + c) % BIGNUM_BASE;
+        } else {
+            u[j + vn] = (unsigned int)t;
+        }
+        q[j] = (unsigned int)qhat;
+    }
+    if (f > 1)
+        div_small_mag(u, u, vn, f);   // unscale the remainder
+}
+
+BIGNUM bignum_divmod(BIGNUM *op1, BIGNUM *op2, BIGNUM *rem) {
+    BIGNUM q = { 0, 0, NULL, 0 };
+    if (op2->size == 0) {
+        fprintf(stderr, "Division by zero in bignum_divmod()\n");
+        if (rem != NULL)
+            *rem = q;
+        return q;
+    }
+    if (cmp_mag(op1->limb, op1->size, op2->limb, op2->size) < 0) {
+        if (rem != NULL)
+            *rem = bignum_copy(op1);
+        return bignum_new(1);
+    }
+    if (op2->size == 1) {
+        unsigned int r = bignum_divmod_small(op1, op2->limb[0], &q);
+        q.negative = (op1->negative ^ op2->negative) && q.size > 0;
+        if (rem != NULL) {
+            *rem = bignum_new(1);
+            rem->limb[0] = r;
+            rem->size = (r > 0);
+            rem->negative = op1->negative && r > 0;
+        }
+        return q;
+    }
+
+    int un = op1->size, vn = op2->size;
+    BIGNUM u = bignum_new(un + 1);
+    memcpy(u.limb, op1->limb, un * sizeof(unsigned int));
+    unsigned int *v = (unsigned int *)malloc(vn * sizeof(unsigned int));
+    if (v == NULL) {
+        fprintf(stderr, "Memory allocation failed in bignum_divmod()\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(v, op2->limb, vn * sizeof(unsigned int));
+    q = bignum_new(un - vn + 1);
+
+    divmod_knuth(q.limb, u.limb, un, v, vn);
+    free(v);
+
+    q.size = un - vn + 1;
+    q.negative = op1->negative ^ op2->negative;
+    bignum_normalize(&q);
+    if (rem != NULL) {
+        u.size = vn;
+        u.negative = op1->negative;
+        bignum_normalize(&u);
+        *rem = u;
+    } else {
+        bignum_clean(&u);
+    }
+    return q;
+}
+
+/*
+ * With decimal limbs the conversion is linear: the top limb without
+ * leading zeros, then nine digits for every other limb.
+ */
+char *bignum_str(BIGNUM *a) {
+    char *s = (char *)malloc(a->size * BIGNUM_DIGITS + 3);
+    if (s == NULL)
+        return NULL;
+    char *p = s;
+    if (a->negative)
+        *p++ = '-';
+    if (a->size == 0) {
+        strcpy(p, "0");
+        return s;
+    }
+    p += sprintf(p, "%u", a->limb[a->size - 1]);
+    for (int i = a->size - 2; i >= 0; i--) {
+        unsigned int limb = a->limb[i];
+        for (int d = BIGNUM_DIGITS - 1; d >= 0; d--) {
+            p[d] = (char)('0' + limb % 10);
+            limb /= 10;
+        }
+        p += BIGNUM_DIGITS;
+    }
+    *p = '\0';
+    return s;
+}
+
+/*
+ * f1, f2 hold F(i-1), F(i); each step adds the smaller into the larger
+ * and swaps roles, so no number is ever copied or reallocated.
+ */
+BIGNUM bignum_fibonacci(int n) {
+    BIGNUM f1 = { 0, 0, NULL, 0 }, f2 = { 0, 0, NULL, 0 };
+    if (n <= 0)
+        return f1;
+
+    // F(n) has about 0.209*n decimal digits
+    int capacity = (int)(n * 0.20899 / BIGNUM_DIGITS) + 2;
+    bignum_reserve(&f1, capacity);
+    bignum_reserve(&f2, capacity);
+    f2.limb[0] = 1;
+    f2.size = 1;    // f1 = F(0) = 0, f2 = F(1) = 1
+    for (int i = 2; i <= n; i++) {
+        bignum_add_to(&f1, &f2);    // f1 = F(i)
+        BIGNUM t = f1;
         f1 = f2;
-        f2 = sum;
+        f2 = t;
     }
-    // f2 now holds Fibonacci(n)
+    bignum_clean(&f1);
     return f2;
 }
+
+/*
+ * Walk the digit list from the least significant end (tail node);
+ * a leading '-' node marks a negative number.
+ */
+BIGNUM bigint_to_bignum(BIGINT b) {
+    BIGNUM a = { 0, 0, NULL, 0 };
+    if (b == NULL)
+        return a;
+    bignum_reserve(&a, b->length / BIGNUM_DIGITS + 1);
+    unsigned int limb = 0, scale = 1;
+    int digits = 0;
+    for (NODE *p = b->end; p != NULL; p = p->prev) {
+        if (!isdigit((unsigned char)p->data))
+            continue;
+        limb += (p->data - '0') * scale;
+        scale *= 10;
+        if (++digits == BIGNUM_DIGITS) {
+            a.limb[a.size++] = limb;
+            limb = 0;
+            scale = 1;
+            digits = 0;
+        }
+    }
+    if (digits > 0)
+        a.limb[a.size++] = limb;
+    a.negative = (b->start != NULL && b->start->data == '-');
+    bignum_normalize(&a);
+    return a;
+}
+
+/*
+ * Emit the digits of each limb from the least significant end, inserting
+ * at the start of the list; the top limb is emitted without leading zeros.
+ */
+BIGINT bignum_to_bigint(BIGNUM *a) {
+    BIGINT b = (BIGINT)malloc(sizeof(DLL));
+    if (b == NULL) {
+        fprintf(stderr, "Memory allocation failed in bignum_to_bigint()\n");
+        exit(EXIT_FAILURE);
+    }
+    b->length = 0;
+    b->start = b->end = NULL;
+    b->pool = NULL;
+    dll_pool_init(b, a->size * BIGNUM_DIGITS + 1);
+
+    if (a->size == 0) {
+        dll_insert_end(b, dll_pool_node(b, '0'));
+        return b;
+    }
+    for (int i = 0; i < a->size; i++) {
+        unsigned int limb = a->limb[i];
+        for (int d = 0; d < BIGNUM_DIGITS; d++) {
+            if (i == a->size - 1 && limb == 0)
+                break;
+            dll_insert_start(b, dll_pool_node(b, (char)('0' + limb % 10)));
+            limb /= 10;
+        }
+    }
+    if (a->negative)
+        dll_insert_start(b, dll_pool_node(b, '-'));
+    return b;
+}
+
+void bignum_clean(BIGNUM *a) {
+    free(a->limb);
+    a->limb = NULL;
+    a->size = 0;
+    a->capacity = 0;
+    a->negative = 0;
+}
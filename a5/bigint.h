@@ -8,6 +8,24 @@
  */
 typedef DLL *BIGINT;
 
+#define BIGNUM_BASE 1000000000   // 10^9, nine decimal digits per limb
+#define BIGNUM_DIGITS 9
+#define KARATSUBA_THRESHOLD 32   // limbs from which bignum_mul() uses Karatsuba
+#define TOOM3_THRESHOLD 200      // limbs from which bignum_mul() uses Toom-3
+
+/*
+ * Contiguous limb-array big number in sign-magnitude form.
+ * limb[0..size-1] holds the magnitude in base 10^9, least significant limb
+ * first; size is 0 for the value zero, which is never negative.
+ * capacity is the allocated length.
+ */
+typedef struct {
+    int size;
+    int capacity;
+    unsigned int *limb;
+    int negative;
+} BIGNUM;
+
 /* 
  * Creates and returns a BIGINT object by converting the digit string.
  * The digit string is assumed to consist solely of digit characters ('0'-'9').
@@ -29,4 +47,98 @@ BIGINT bigint_add(BIGINT oprand1, BIGINT oprand2);
  */
 BIGINT bigint_fibonacci(int n);
 
+/*
+ * Create a BIGNUM from a digit string, nine digits per limb, in linear time.
+ * A leading '-' makes it negative; other non-digit characters are skipped
+ * as in bigint().
+ * @param digitstr - the decimal digit string
+ * @return the BIGNUM value
+ */
+BIGNUM bignum(char *digitstr);
+
+/*
+ * Add op into acc in place (acc += op), growing acc's buffer as needed.
+ * acc and op may be the same number.
+ * @param acc - the accumulator
+ * @param op  - the operand
+ */
+void bignum_add_to(BIGNUM *acc, BIGNUM *op);
+
+/*
+ * Add two BIGNUM operands and return the sum as a new BIGNUM.
+ */
+BIGNUM bignum_add(BIGNUM *op1, BIGNUM *op2);
+
+/*
+ * Return op1 - op2 as a new BIGNUM.
+ */
+BIGNUM bignum_sub(BIGNUM *op1, BIGNUM *op2);
+
+/*
+ * Compare two BIGNUM values.
+ * @return -1, 0 or 1 as op1 is less than, equal to or greater than op2
+ */
+int bignum_cmp(BIGNUM *op1, BIGNUM *op2);
+
+/*
+ * Return op1 * op2 as a new BIGNUM. Operands shorter than the Karatsuba
+ * threshold use schoolbook multiplication, longer ones Karatsuba, and
+ * balanced operands from the Toom-3 threshold up Toom-3.
+ */
+BIGNUM bignum_mul(BIGNUM *op1, BIGNUM *op2);
+
+/*
+ * Set the limb thresholds of bignum_mul(); 0 restores a default.
+ * Used by the benchmark to force one algorithm.
+ */
+void bignum_mul_thresholds(int karatsuba, int toom3);
+
+/*
+ * Divide by a small divisor d > 0 in one pass.
+ * @param op - the dividend
+ * @param d  - the divisor
+ * @param q  - receives op / d truncated toward zero, or NULL
+ * @return |op| mod d
+ */
+unsigned int bignum_divmod_small(BIGNUM *op, unsigned int d, BIGNUM *q);
+
+/*
+ * Long division (Knuth's algorithm D) with truncation toward zero,
+ * so that op1 = q*op2 + r and r has the sign of op1.
+ * @param op1 - the dividend
+ * @param op2 - the divisor, nonzero
+ * @param rem - receives the remainder r, or NULL
+ * @return the quotient q
+ */
+BIGNUM bignum_divmod(BIGNUM *op1, BIGNUM *op2, BIGNUM *rem);
+
+/*
+ * Return the decimal string of a BIGNUM, allocated with malloc(), in
+ * linear time (each base 10^9 limb is nine digits).
+ */
+char *bignum_str(BIGNUM *a);
+
+/*
+ * Compute and return Fibonacci(n) as a BIGNUM with in-place additions
+ * on two preallocated buffers.
+ * @param n - input integer, Fibonacci(n) = 0 for n <= 0
+ */
+BIGNUM bignum_fibonacci(int n);
+
+/*
+ * Convert a BIGINT digit list to a BIGNUM.
+ */
+BIGNUM bigint_to_bignum(BIGINT b);
+
+/*
+ * Convert a BIGNUM to a newly allocated BIGINT digit list
+ * (head node = most significant digit, or '-' for a negative number).
+ */
+BIGINT bignum_to_bigint(BIGNUM *a);
+
+/*
+ * Free the limbs of a BIGNUM and reset it to zero.
+ */
+void bignum_clean(BIGNUM *a);
+
 #endif
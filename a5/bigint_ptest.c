@@ -7,6 +7,8 @@
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "dllist.h"
 #include "bigint.h"
 
@@ -15,9 +17,9 @@ char *oprs2[] = { "222", "3333", "333333333334", "8888888888888888889" };
 int tests[] = { 1, 2, 3, 10, 40, 100 };
 
 void display_bigint(BIGINT bignumber) {
-	NODE *ptr = bignumber.start;
+	NODE *ptr = bignumber->start;
 	while (ptr != NULL) {
-		printf("%d", ptr->data);
+		printf("%c", ptr->data);
 		ptr = ptr->next;
 	}
 }
@@ -26,13 +28,14 @@ void test_bigint() {
 	printf("------------------\n");
 	printf("Test: bigint\n\n");
 	int n = sizeof oprs1 / sizeof *oprs1;
-	BIGINT num = { 0 };
+	BIGINT num = NULL;
 	for (int i = 0; i < n; i++) {
 		printf("bigint(%s): ", oprs1[i]);
 		num = bigint(oprs1[i]);
 		display_bigint(num);
 		printf("\n");
-		dll_clean(&num);
+		dll_clean(num);
+		free(num);
 	}
 	printf("\n");
 }
@@ -41,7 +44,7 @@ void test_bigint_add() {
 	printf("------------------\n");
 	printf("Test: bigint_add\n\n");
 	int n = sizeof oprs1 / sizeof *oprs1;
-	BIGINT a = { 0 }, b = { 0 }, c = { 0 };
+	BIGINT a = NULL, b = NULL, c = NULL;
 	for (int i = 0; i < n; i++) {
 		printf("%s+%s:", oprs1[i], oprs2[i]);
 		a = bigint(oprs1[i]);
@@ -49,9 +52,12 @@ void test_bigint_add() {
 		c = bigint_add(a, b);
 		display_bigint(c);
 		printf("\n");
-		dll_clean(&a);
-		dll_clean(&b);
-		dll_clean(&c);
+		dll_clean(a);
+		dll_clean(b);
+		dll_clean(c);
+		free(a);
+		free(b);
+		free(c);
 	}
 	printf("\n");
 }
@@ -60,13 +66,198 @@ void test_bigint_fibonacci() {
 	printf("------------------\n");
 	printf("Test: big_fibonacci\n\n");
 	int n = sizeof tests / sizeof *tests;
-	BIGINT f = { 0 };
+	BIGINT f = NULL;
 	for (int i = 0; i < n; i++) {
 		printf("bigint_fibonacci(%d): ", tests[i]);
 		f = bigint_fibonacci(tests[i]);
 		display_bigint(f);
 		printf("\n");
-		dll_clean(&f);
+		dll_clean(f);
+		free(f);
+	}
+	printf("\n");
+}
+
+void test_bignum() {
+	printf("------------------\n");
+	printf("Test: bignum, bignum_add_to, bignum_to_bigint\n\n");
+	int n = sizeof oprs1 / sizeof *oprs1;
+	for (int i = 0; i < n; i++) {
+		BIGNUM a = bignum(oprs1[i]);
+		BIGINT b = bigint(oprs2[i]);
+		BIGNUM c = bigint_to_bignum(b);
+		bignum_add_to(&a, &c);
+		BIGINT s = bignum_to_bigint(&a);
+		printf("%s+%s:", oprs1[i], oprs2[i]);
+		display_bigint(s);
+		printf("\n");
+		bignum_clean(&a);
+		bignum_clean(&c);
+		dll_clean(b);
+		dll_clean(s);
+		free(b);
+		free(s);
+	}
+	printf("\n");
+}
+
+char *arith1[] = { "0", "-7", "123456789012345678901234567890", "-1000000000000000000",
+		"99999999999999999999999999999999999999" };
+char *arith2[] = { "5", "3", "987654321", "999999999", "-12345678901234567891" };
+
+void print_bignum(BIGNUM *a) {
+	char *s = bignum_str(a);
+	printf("%s", s);
+	free(s);
+}
+
+void test_bignum_arith() {
+	printf("------------------\n");
+	printf("Test: bignum_sub, bignum_cmp, bignum_mul, bignum_divmod\n\n");
+	int n = sizeof arith1 / sizeof *arith1;
+	for (int i = 0; i < n; i++) {
+		BIGNUM a = bignum(arith1[i]), b = bignum(arith2[i]), r;
+		BIGNUM d = bignum_sub(&a, &b);
+		BIGNUM p = bignum_mul(&a, &b);
+		BIGNUM q = bignum_divmod(&a, &b, &r);
+		printf("a=%s, b=%s, cmp:%d\n", arith1[i], arith2[i], bignum_cmp(&a, &b));
+		printf("a-b:");
+		print_bignum(&d);
+		printf("\na*b:");
+		print_bignum(&p);
+		printf("\na/b:");
+		print_bignum(&q);
+		printf(", a%%b:");
+		print_bignum(&r);
+		printf("\n");
+		bignum_clean(&a);
+		bignum_clean(&b);
+		bignum_clean(&d);
+		bignum_clean(&p);
+		bignum_clean(&q);
+		bignum_clean(&r);
+	}
+
+	// multiply across the algorithm thresholds and divide back
+	BIGNUM f = bignum_fibonacci(40000), g = bignum_fibonacci(30000), r;
+	int ok = 1;
+	int thresholds[][2] = { { 1 << 30, 1 << 30 }, { 4, 1 << 30 }, { 4, 6 }, { 0, 0 } };
+	BIGNUM p0 = { 0, 0, NULL, 0 };
+	for (int i = 0; i < 4; i++) {
+		bignum_mul_thresholds(thresholds[i][0], thresholds[i][1]);
+		BIGNUM p = bignum_mul(&f, &g);
+		BIGNUM q = bignum_divmod(&p, &g, &r);
+		ok = ok && bignum_cmp(&q, &f) == 0 && r.size == 0;
+		if (i == 0)
+			p0 = p;
+		else {
+			ok = ok && bignum_cmp(&p, &p0) == 0;
+			bignum_clean(&p);
+		}
+		bignum_clean(&q);
+		bignum_clean(&r);
+	}
+	printf("F(40000)*F(30000)/F(30000) == F(40000) for all algorithms: %d\n", ok);
+	printf("F(40000) mod 1000000007: %u\n", bignum_divmod_small(&f, 1000000007, NULL));
+	bignum_clean(&p0);
+	bignum_clean(&f);
+	bignum_clean(&g);
+	printf("\n");
+}
+
+/*
+ * Fibonacci(n) with the digit-list bigint_add(), as a baseline for timing.
+ */
+BIGINT dll_fibonacci(int n) {
+	BIGINT f1 = bigint("0"), f2 = bigint("1");
+	for (int i = 2; i <= n; i++) {
+		BIGINT sum = bigint_add(f1, f2);
+		dll_clean(f1);
+		free(f1);
+		f1 = f2;
+		f2 = sum;
+	}
+	dll_clean(f1);
+	free(f1);
+	return f2;
+}
+
+void time_test_fibonacci(int n) {
+	printf("------------------\n");
+	printf("Test: runtime, bigint_fibonacci(%d)\n\n", n);
+	clock_t t1 = clock();
+	BIGINT a = dll_fibonacci(n);
+	clock_t t2 = clock();
+	BIGINT b = bigint_fibonacci(n);
+	clock_t t3 = clock();
+	double s1 = (double) (t2 - t1) / CLOCKS_PER_SEC;
+	double s2 = (double) (t3 - t2) / CLOCKS_PER_SEC;
+	NODE *p = a->start, *q = b->start;
+	while (p != NULL && q != NULL && p->data == q->data) {
+		p = p->next;
+		q = q->next;
+	}
+	printf("digit list: %0.3f (s), limb array: %0.3f (s), speedup: %0.1f, equal: %d\n",
+			s1, s2, s1 / (s2 > 0 ? s2 : 1e-6), p == NULL && q == NULL);
+	dll_clean(a);
+	dll_clean(b);
+	free(a);
+	free(b);
+	printf("\n");
+}
+
+/*
+ * Time one product of two d-digit numbers with the given thresholds.
+ */
+double time_mul(BIGNUM *a, BIGNUM *b, int karatsuba, int toom3) {
+	bignum_mul_thresholds(karatsuba, toom3);
+	clock_t t1 = clock();
+	int reps = 0;
+	do {
+		BIGNUM p = bignum_mul(a, b);
+		bignum_clean(&p);
+		reps++;
+	} while (clock() - t1 < CLOCKS_PER_SEC / 20);
+	bignum_mul_thresholds(0, 0);
+	return (double) (clock() - t1) / CLOCKS_PER_SEC / reps;
+}
+
+void time_test_mul(int max_digits) {
+	printf("------------------\n");
+	printf("Test: runtime, bignum_mul (s per product)\n\n");
+	printf("%9s %11s %11s %11s %11s %11s\n", "digits", "schoolbook", "karatsuba",
+			"toom3", "bignum_mul", "divmod");
+	for (int d = 10; d <= max_digits; d *= 10) {
+		char *s1 = malloc(d + 1), *s2 = malloc(d + 1);
+		for (int i = 0; i < d; i++) {
+			s1[i] = '1' + rand() % 9;
+			s2[i] = '1' + rand() % 9;
+		}
+		s1[d] = s2[d] = '\0';
+		BIGNUM a = bignum(s1), b = bignum(s2);
+		BIGNUM c = bignum_mul(&a, &b), r;
+		printf("%9d ", d);
+		if (d <= 100000)
+			printf("%11.3g ", time_mul(&a, &b, 1 << 30, 1 << 30));
+		else
+			printf("%11s ", "-");
+		printf("%11.3g ", time_mul(&a, &b, 0, 1 << 30));
+		printf("%11.3g ", time_mul(&a, &b, 0, 1));
+		printf("%11.3g ", time_mul(&a, &b, 0, 0));
+		if (d <= 100000) {
+			// long division is quadratic, like schoolbook
+			clock_t t1 = clock();
+			BIGNUM q = bignum_divmod(&c, &b, &r);
+			printf("%11.3g\n", (double) (clock() - t1) / CLOCKS_PER_SEC);
+			bignum_clean(&q);
+			bignum_clean(&r);
+		} else
+			printf("%11s\n", "-");
+		bignum_clean(&a);
+		bignum_clean(&b);
+		bignum_clean(&c);
+		free(s1);
+		free(s2);
 	}
 	printf("\n");
 }
@@ -76,14 +267,21 @@ int main(int argc, char* args[]) {
 		test_bigint();
 		test_bigint_add();
 		test_bigint_fibonacci();
+		test_bignum();
+		test_bignum_arith();
 	} else {
-		if (argc == 2) {
+		if (argc == 3 && strcmp(args[1], "time") == 0) {
+			time_test_fibonacci(atoi(args[2]));
+		} else if (strcmp(args[1], "mul") == 0) {
+			time_test_mul(argc == 3 ? atoi(args[2]) : 1000000);
+		} else if (argc == 2) {
 			int n = atoi(args[1]);
 			printf("\nbigint_fibonacci(%d):", n);
 			BIGINT s = bigint_fibonacci(n);
 			display_bigint(s);
-			printf("\ndigit count:%d", s.length);
-			dll_clean(&s);
+			printf("\ndigit count:%d", s->length);
+			dll_clean(s);
+			free(s);
 		} else if (argc == 3) {
 			char *opr1 = args[2];
 			char *opr2 = args[3];
@@ -95,9 +293,12 @@ int main(int argc, char* args[]) {
 			display_bigint(b);
 			printf("=");
 			display_bigint(s);
-			dll_clean(&a);
-			dll_clean(&b);
-			dll_clean(&s);
+			dll_clean(a);
+			dll_clean(b);
+			dll_clean(s);
+			free(a);
+			free(b);
+			free(s);
 		}
 	}
 	return 0;
@@ -1,10 +1,30 @@
 #include "dllist.h"
 
+/*
+ * A pool chunk: a header followed by its nodes.
+ */
+struct pool_chunk {
+    struct pool_chunk *next;
+    NODE nodes[];
+};
+
+static DLLCOUNTERS counters;
+
+DLLCOUNTERS dll_counters(void) {
+    return counters;
+}
+
+void dll_counters_reset(void) {
+    counters.mallocs = 0;
+    counters.frees = 0;
+}
+
 /*
  * Create and return a new node using malloc() with the passed data value.
  */
 NODE *dll_node(char value) {
     NODE *new_node = (NODE *)malloc(sizeof(NODE));
+    counters.mallocs++;
     if (new_node == NULL) {
         fprintf(stderr, "Memory allocation failed in dll_node.\n");
         exit(EXIT_FAILURE);
@@ -15,6 +35,78 @@ NODE *dll_node(char value) {
     return new_node;
 }
 
+/*
+ * Attach an empty pool; the first chunk is allocated on demand.
+ */
+void dll_pool_init(DLL *dllp, int chunk_size) {
+    if (dllp == NULL || dllp->pool != NULL)
+        return;
+    NODEPOOL *pool = (NODEPOOL *)malloc(sizeof(NODEPOOL));
+    counters.mallocs++;
+    if (pool == NULL) {
+        fprintf(stderr, "Memory allocation failed in dll_pool_init.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (chunk_size <= 0)
+        chunk_size = DLL_POOL_CHUNK;
+    // the first chunk gets chunk_size nodes, so start at half for the doubling
+    pool->chunk_size = (chunk_size + 1) / 2;
+    pool->used = pool->chunk_size;
+    pool->chunks = NULL;
+    pool->free = NULL;
+    dllp->pool = pool;
+}
+
+/*
+ * Take a node from the free list, else from the current chunk, else from
+ * a new chunk twice the size of the last one.
+ */
+NODE *dll_pool_node(DLL *dllp, char value) {
+    if (dllp == NULL || dllp->pool == NULL)
+        return dll_node(value);
+
+    NODEPOOL *pool = dllp->pool;
+    NODE *np = pool->free;
+    if (np != NULL) {
+        pool->free = np->next;
+    } else {
+        if (pool->used == pool->chunk_size) {
+            int size = pool->chunk_size;
+            if (size < DLL_POOL_MAX_CHUNK)
+                size *= 2;
+            struct pool_chunk *chunk =
+                (struct pool_chunk *)malloc(sizeof(struct pool_chunk) + size * sizeof(NODE));
+            counters.mallocs++;
+            if (chunk == NULL) {
+                fprintf(stderr, "Memory allocation failed in dll_pool_node.\n");
+                exit(EXIT_FAILURE);
+            }
+            chunk->next = pool->chunks;
+            pool->chunks = chunk;
+            pool->chunk_size = size;
+            pool->used = 0;
+        }
+        np = &pool->chunks->nodes[pool->used++];
+    }
+    np->data = value;
+    np->prev = NULL;
+    np->next = NULL;
+    return np;
+}
+
+/*
+ * Give a deleted node back to the pool of its list, or free it.
+ */
+static void release_node(DLL *dllp, NODE *np) {
+    if (dllp->pool != NULL) {
+        np->next = dllp->pool->free;
+        dllp->pool->free = np;
+    } else {
+        free(np);
+        counters.frees++;
+    }
+}
+
 /*
  * Insert a given node at the beginning of a doubly linked list.
  */
@@ -74,7 +166,7 @@ void dll_delete_start(DLL *dllp) {
         dllp->end = NULL;
     }
     
-    free(temp);
+    release_node(dllp, temp);
     dllp->length--;
 }
 
@@ -95,7 +187,7 @@ void dll_delete_end(DLL *dllp) {
         dllp->start = NULL;
     }
     
-    free(temp);
+    release_node(dllp, temp);
     dllp->length--;
 }
 
@@ -106,11 +198,25 @@ void dll_clean(DLL *dllp) {
     if (dllp == NULL)
         return;
     
-    NODE *current = dllp->start;
-    while (current != NULL) {
-        NODE *temp = current;
-        current = current->next;
-        free(temp);
+    if (dllp->pool != NULL) {
+        struct pool_chunk *chunk = dllp->pool->chunks;
+        while (chunk != NULL) {
+            struct pool_chunk *temp = chunk;
+            chunk = chunk->next;
+            free(temp);
+            counters.frees++;
+        }
+        free(dllp->pool);
+        counters.frees++;
+        dllp->pool = NULL;
+    } else {
+        NODE *current = dllp->start;
+        while (current != NULL) {
+            NODE *temp = current;
+            current = current->next;
+            free(temp);
+            counters.frees++;
+        }
     }
     
     dllp->start = NULL;
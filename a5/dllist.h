@@ -13,20 +13,71 @@ typedef struct node {
     struct node *next;
 } NODE;
 
+#define DLL_POOL_CHUNK 256       // default nodes in the first pool chunk
+#define DLL_POOL_MAX_CHUNK 65536  // chunks double in size up to this many nodes
+
+/*
+ * Node pool of a DLL: nodes are carved from large chunks and recycled
+ * through a free list, and all chunks are released at once by dll_clean().
+ */
+typedef struct node_pool {
+    int chunk_size;        // nodes in the current chunk
+    int used;              // nodes carved from the current chunk
+    struct pool_chunk *chunks;  // allocated chunks, newest first
+    NODE *free;            // recycled nodes linked by next
+} NODEPOOL;
+
 /* 
  * Define a structure DLL to hold the length, start and end node addresses of a doubly linked list.
+ * pool is NULL for a list of malloc()ed nodes, see dll_pool_init().
  */
 typedef struct dll {
     int length;
     NODE *start;
     NODE *end;
+    NODEPOOL *pool;
 } DLL;
 
+/*
+ * Allocation counters of the dllist module, for measuring pool savings.
+ */
+typedef struct {
+    long mallocs;  // calls to malloc() for nodes, chunks and pools
+    long frees;    // calls to free() for the same
+} DLLCOUNTERS;
+
 /*
  * Create and return a new node using malloc() with passed data value and returns pointer of the node.
  */
 NODE *dll_node(char value);
 
+/*
+ * Attach a node pool to an empty doubly linked list.
+ * All nodes inserted into the list must then come from dll_pool_node(dllp, ...),
+ * deleted nodes go back to the pool, and dll_clean() frees the chunks and the pool.
+ * @param dllp       - reference to input DLL variable
+ * @param chunk_size - nodes in the first chunk, 0 for DLL_POOL_CHUNK
+ */
+void dll_pool_init(DLL *dllp, int chunk_size);
+
+/*
+ * Create a new node from the pool of a list with the passed data value,
+ * or with dll_node() if the list has no pool.
+ * @param dllp  - reference to the DLL the node will be inserted into
+ * @param value - the data value
+ */
+NODE *dll_pool_node(DLL *dllp, char value);
+
+/*
+ * Return the allocation counters accumulated since the last reset.
+ */
+DLLCOUNTERS dll_counters(void);
+
+/*
+ * Reset the allocation counters to zero.
+ */
+void dll_counters_reset(void);
+
 /*
  * Insert a given node at the beginning of a doubly linked list.
  * @param dllp - reference to input DLL variable 
@@ -55,6 +106,7 @@ void dll_delete_end(DLL *dllp);
 
 /*
  * Clean and free the nodes of a doubly linked list and reset start and length.
+ * A pooled list frees its chunks in O(chunks) and detaches the pool.
  * @param dllp - reference to input DLL variable 
  */
 void dll_clean(DLL *dllp);
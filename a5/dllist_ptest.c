@@ -8,6 +8,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "dllist.h"
 
 char tests[] = { 'A', 'B', 'C', 'D' };
@@ -113,12 +115,74 @@ void test_dll_delete_end() {
 	printf("\n");
 }
 
+void test_dll_pool() {
+	printf("------------------\n");
+	printf("Test: dll_pool_init, dll_pool_node\n\n");
+
+	int n = sizeof tests / sizeof *tests;
+	DLL dllist = { 0 };
+	dll_counters_reset();
+	dll_pool_init(&dllist, 2);
+	for (int i = 0; i < n; i++) {
+		dll_insert_end(&dllist, dll_pool_node(&dllist, tests[i]));
+	}
+	display_forward(&dllist);
+	printf("\n");
+	dll_delete_start(&dllist);
+	dll_delete_end(&dllist);
+	display_forward(&dllist);
+	printf("\n");
+	// the deleted nodes are recycled, no new chunk is needed
+	dll_insert_start(&dllist, dll_pool_node(&dllist, 'E'));
+	dll_insert_end(&dllist, dll_pool_node(&dllist, 'F'));
+	display_backward(&dllist);
+	printf("\n");
+	dll_clean(&dllist);
+	DLLCOUNTERS c = dll_counters();
+	printf("mallocs: %ld, frees: %ld, pool: %s\n", c.mallocs, c.frees,
+			dllist.pool == NULL ? "NULL" : "attached");
+	printf("\n");
+}
+
+/*
+ * Build and clean a list of n nodes, with or without a pool.
+ */
+void time_test_pool(int n) {
+	printf("------------------\n");
+	printf("Test: runtime, %d nodes\n\n", n);
+	for (int pooled = 0; pooled <= 1; pooled++) {
+		DLL dllist = { 0 };
+		dll_counters_reset();
+		clock_t t1 = clock();
+		if (pooled)
+			dll_pool_init(&dllist, 0);
+		for (int i = 0; i < n; i++) {
+			dll_insert_end(&dllist, dll_pool_node(&dllist, 'A' + i % 26));
+		}
+		for (int i = 0; i < n / 2; i++) {
+			dll_delete_start(&dllist);
+			dll_insert_end(&dllist, dll_pool_node(&dllist, 'a' + i % 26));
+		}
+		dll_clean(&dllist);
+		double s = (double) (clock() - t1) / CLOCKS_PER_SEC;
+		DLLCOUNTERS c = dll_counters();
+		printf("%s: %0.3f (s), mallocs: %ld, frees: %ld\n", pooled ? "pool  " : "malloc",
+				s, c.mallocs, c.frees);
+	}
+	printf("\n");
+}
+
 int main(int argc, char* args[]) {
+	if (argc > 1) {
+		time_test_pool(atoi(args[1]));
+		return 0;
+	}
 	test_dll_node();
 	test_dll_insert_start();
 	test_dll_insert_end();
 	test_dll_delete_start();
 	test_dll_delete_end();
+	test_dll_pool();
 	return 0;
 }
 
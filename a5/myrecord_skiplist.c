@@ -0,0 +1,218 @@
+#include "myrecord_skiplist.h"
+#include <stddef.h>
+
+/*
+ * A pool chunk: a header followed by the bytes nodes are carved from.
+ */
+struct skl_chunk {
+    struct skl_chunk *next;
+    size_t pad;          // bytes starts 16-byte aligned, as malloc() returns;
+                         // node_size() keeps the nodes after it pointer aligned
+    char bytes[];
+};
+
+/*
+ * Bytes of a node with the given number of forward pointers, rounded up so
+ * that the next node carved from a chunk stays aligned.
+ */
+static size_t node_size(int level) {
+    size_t size = offsetof(SKLNODE, next) + level * sizeof(SKLNODE *);
+    return (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+}
+
+/*
+ * Take a node of the given level from the free list of that level, or carve
+ * it from the newest chunk, allocating a chunk twice as large when it is full.
+ */
+static SKLNODE *skl_alloc(SKL *sklp, int level) {
+    SKLNODE *np = sklp->free[level];
+    if (np != NULL) {
+        sklp->free[level] = np->next[0];
+        return np;
+    }
+    size_t size = node_size(level);
+    if (sklp->chunks == NULL || sklp->used + size > sklp->size) {
+        size_t chunk_size = (sklp->size == 0) ? SKL_POOL_CHUNK : 2 * sklp->size;
+        if (chunk_size > SKL_POOL_MAX_CHUNK)
+            chunk_size = SKL_POOL_MAX_CHUNK;
+        struct skl_chunk *chunk = (struct skl_chunk *)malloc(sizeof(struct skl_chunk) + chunk_size);
+        if (chunk == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(EXIT_FAILURE);
+        }
+        chunk->next = sklp->chunks;
+        sklp->chunks = chunk;
+        sklp->size = chunk_size;
+        sklp->used = 0;
+    }
+    np = (SKLNODE *)(sklp->chunks->bytes + sklp->used);
+    sklp->used += size;
+    np->level = level;
+    return np;
+}
+
+/*
+ * Random level of a new node: level i + 1 with probability 3/4 * (1/4)^i,
+ * from an xorshift generator kept in the list.
+ */
+static int random_level(SKL *sklp) {
+    unsigned x = (sklp->seed != 0) ? sklp->seed : 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sklp->seed = x;
+    int level = 1;
+    while ((x & 3) == 0 && level < SKL_MAX_LEVEL) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+/*
+ * Walk down from the top level to the first node whose name is not less
+ * than name. If update is not NULL, update[i] is set to the last node before
+ * it on level i.
+ */
+static SKLNODE *skl_find(SKL *sklp, char *name, SKLNODE **update) {
+    SKLNODE *x = sklp->head;
+    for (int i = sklp->level - 1; i >= 0; i--) {
+        while (x->next[i] != NULL && strcmp(x->next[i]->data.name, name) < 0) {
+            x = x->next[i];
+        }
+        if (update != NULL)
+            update[i] = x;
+    }
+    return x->next[0];
+}
+
+/**
+ * Searches the skip list for the first node whose record name matches the given key.
+ *
+ * @param sklp - pointer to the skip list structure.
+ * @param name - the key to search for.
+ * @return Pointer to the found node if present; otherwise NULL.
+ */
+SKLNODE *skl_search(SKL *sklp, char *name) {
+    if (sklp == NULL || sklp->head == NULL || name == NULL) {
+        return NULL;
+    }
+    SKLNODE *np = skl_find(sklp, name, NULL);
+    return (np != NULL && strcmp(np->data.name, name) == 0) ? np : NULL;
+}
+
+/**
+ * Inserts a new record into the skip list while keeping the list sorted by the record name.
+ *
+ * @param sklp - pointer to the skip list structure.
+ * @param name - name field of the new record.
+ * @param score - the score of the new record.
+ */
+void skl_insert(SKL *sklp, char *name, float score) {
+    if (sklp == NULL || name == NULL) {
+        return;
+    }
+    if (sklp->head == NULL) {
+        sklp->head = skl_alloc(sklp, SKL_MAX_LEVEL);
+        memset(sklp->head->next, 0, SKL_MAX_LEVEL * sizeof(SKLNODE *));
+        sklp->level = 0;
+    }
+
+    // The key is the name as stored, truncated like in sll_insert.
+    RECORD data;
+    strncpy(data.name, name, sizeof(data.name) - 1);
+    data.name[sizeof(data.name) - 1] = '\0';
+    data.score = score;
+
+    SKLNODE *update[SKL_MAX_LEVEL];
+    skl_find(sklp, data.name, update);
+    int level = random_level(sklp);
+    while (sklp->level < level) {
+        update[sklp->level++] = sklp->head;
+    }
+    SKLNODE *new_node = skl_alloc(sklp, level);
+    new_node->data = data;
+    for (int i = 0; i < level; i++) {
+        new_node->next[i] = update[i]->next[i];
+        update[i]->next[i] = new_node;
+    }
+    sklp->length++;
+}
+
+/**
+ * Deletes the first node from the skip list whose record name matches the given key.
+ *
+ * @param sklp - pointer to the skip list structure.
+ * @param name - the key used to find the node for deletion.
+ * @return 1 if a node was deleted; 0 otherwise.
+ */
+int skl_delete(SKL *sklp, char *name) {
+    if (sklp == NULL || sklp->head == NULL || name == NULL) {
+        return 0;
+    }
+    SKLNODE *update[SKL_MAX_LEVEL];
+    SKLNODE *np = skl_find(sklp, name, update);
+    if (np == NULL || strcmp(np->data.name, name) != 0) {
+        return 0;
+    }
+    // The first matching node is the first node at or after the key on
+    // every level it belongs to.
+    for (int i = 0; i < np->level; i++) {
+        update[i]->next[i] = np->next[i];
+    }
+    while (sklp->level > 0 && sklp->head->next[sklp->level - 1] == NULL) {
+        sklp->level--;
+    }
+    np->next[0] = sklp->free[np->level];
+    sklp->free[np->level] = np;
+    sklp->length--;
+    return 1;
+}
+
+/**
+ * Finds the first node whose record name starts with the given prefix.
+ *
+ * @param sklp - pointer to the skip list structure.
+ * @param prefix - the name prefix.
+ * @return Pointer to the first node with the prefix if present; otherwise NULL.
+ */
+SKLNODE *skl_first_prefix(SKL *sklp, char *prefix) {
+    if (sklp == NULL || sklp->head == NULL || prefix == NULL) {
+        return NULL;
+    }
+    SKLNODE *np = skl_find(sklp, prefix, NULL);
+    return (np != NULL && strncmp(np->data.name, prefix, strlen(prefix)) == 0) ? np : NULL;
+}
+
+/**
+ * Gets the node after np if its record name also starts with the prefix.
+ *
+ * @param np - current node of the prefix range.
+ * @param prefix - the name prefix.
+ * @return Pointer to the next node with the prefix if present; otherwise NULL.
+ */
+SKLNODE *skl_next_prefix(SKLNODE *np, char *prefix) {
+    if (np == NULL || prefix == NULL) {
+        return NULL;
+    }
+    np = np->next[0];
+    return (np != NULL && strncmp(np->data.name, prefix, strlen(prefix)) == 0) ? np : NULL;
+}
+
+/**
+ * Frees all memory chunks of the skip list, and with them all nodes, and resets it.
+ *
+ * @param sklp - pointer to the skip list structure.
+ */
+void skl_clean(SKL *sklp) {
+    if (sklp == NULL) {
+        return;
+    }
+    struct skl_chunk *chunk = sklp->chunks;
+    while (chunk != NULL) {
+        struct skl_chunk *temp = chunk;
+        chunk = chunk->next;
+        free(temp);
+    }
+    memset(sklp, 0, sizeof(SKL));
+}
@@ -0,0 +1,104 @@
+#ifndef MYRECORD_SKIPLIST_H
+#define MYRECORD_SKIPLIST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "myrecord_sllist.h"
+
+#define SKL_MAX_LEVEL 32           // most forward pointers a node can have
+#define SKL_POOL_CHUNK 16384       // bytes of the first pool chunk
+#define SKL_POOL_MAX_CHUNK 4194304 // chunks double in size up to this many bytes
+
+/**
+ * Skip list node structure
+ * data  - RECORD data
+ * level - number of forward pointers of the node
+ * next  - next[i] points to the next node of level greater than i
+ */
+typedef struct skl_node {
+  RECORD data;
+  int level;
+  struct skl_node *next[];
+} SKLNODE;
+
+/**
+ * Skip list structure, the records sorted by name as in SLL.
+ * A zero-initialized SKL is an empty list.
+ * length  - the number of nodes of the skip list
+ * level   - the highest level of a node in the list
+ * head    - sentinel node with SKL_MAX_LEVEL forward pointers, or NULL
+ * seed    - state of the random level generator
+ * chunks  - memory chunks the nodes are carved from, newest first
+ * used    - bytes carved from the newest chunk
+ * size    - bytes of the newest chunk
+ * free    - free[i] lists the deleted nodes of level i, linked by next[0]
+ */
+typedef struct skl {
+  int length;
+  int level;
+  SKLNODE *head;
+  unsigned seed;
+  struct skl_chunk *chunks;
+  size_t used;
+  size_t size;
+  SKLNODE *free[SKL_MAX_LEVEL + 1];
+} SKL;
+
+/**
+ * Search skip list by the key name.
+ *
+ * @param sklp - address of a skip list structure.
+ * @param name - key to search
+ * @return Pointer to the first node with the name if found; otherwise NULL
+ */
+SKLNODE *skl_search(SKL *sklp, char *name);
+
+/**
+ * Insert a new record to skip list at the position sorted by record name field,
+ * before any records of the same name.
+ *
+ * @param sklp - address of a skip list structure.
+ * @param name - name field of the new record.
+ * @param score - the score data of the new record.
+ */
+void skl_insert(SKL *sklp, char *name, float score);
+
+/**
+ * Delete the first node of record matched by the name key from skip list.
+ * The node goes back to the pool of the list.
+ *
+ * @param sklp - address of a skip list structure.
+ * @param name - key used to find the node for deletion.
+ * @return 1 if deleted a matched node, 0 otherwise.
+ */
+int skl_delete(SKL *sklp, char *name);
+
+/**
+ * Find the first node whose name starts with prefix. The records with the
+ * prefix follow it in name order; iterate them with skl_next_prefix().
+ * The empty prefix gives the first node of the list.
+ *
+ * @param sklp - address of a skip list structure.
+ * @param prefix - name prefix.
+ * @return Pointer to the first node with the prefix if any; otherwise NULL
+ */
+SKLNODE *skl_first_prefix(SKL *sklp, char *prefix);
+
+/**
+ * Get the node after np if its name also starts with prefix.
+ *
+ * @param np - a node returned by skl_first_prefix() or skl_next_prefix().
+ * @param prefix - the same name prefix.
+ * @return Pointer to the next node with the prefix if any; otherwise NULL
+ */
+SKLNODE *skl_next_prefix(SKLNODE *np, char *prefix);
+
+/**
+ * Clean skip list, free all its memory chunks at once and reset it.
+ *
+ * @param sklp - address of a skip list structure.
+ */
+void skl_clean(SKL *sklp);
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ --------------------------------------------------
+ File:    myrecord_skiplist_ptest.c
+ About:   public test driver
+ Version: 2025-02-04
+ --------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "myrecord_skiplist.h"
+
+#define SLL_MAX_BENCH 30000   // the linked list is only timed up to this size
+
+RECORD tests[] = { { "A1", 10 }, { "A2", 20 }, { "A3", 30 }, { "A4", 40 }, {
+		"A5", 50 }, { "A6", 60 }, { "A7", 70 }, { "A8", 80 }, { "A9", 90 }, {
+		"A10", 100 } };
+char *delete_items[] = { "A2", "A4", "A6", "A8", "B" };
+char *search_items[] = { "A1", "A3", "A5", "B" };
+char *prefix_items[] = { "A1", "A", "A9", "B", "" };
+
+void skl_display(SKL *sklp) {
+	SKLNODE *np = sklp->head == NULL ? NULL : sklp->head->next[0];
+	printf("length %d ", sklp->length);
+	while (np != NULL) {
+		printf("%s %.1f ", np->data.name, np->data.score);
+		np = np->next[0];
+	}
+}
+
+void test_skl_insert() {
+	printf("------------------\n");
+	printf("Test: skl_insert\n\n");
+	int n = sizeof(tests) / sizeof(RECORD);
+	SKL sklist = { 0 };
+	printf("given skip list:");
+	skl_display(&sklist);
+	printf("\n");
+	for (int i = n - 2; i >= n / 2; i--) {
+		printf("skl_insert(%s %0.1f): ", tests[i].name, tests[i].score);
+		skl_insert(&sklist, tests[i].name, tests[i].score);
+		skl_display(&sklist);
+		printf("\n");
+	}
+	skl_clean(&sklist);
+	printf("\n");
+}
+
+void test_skl_search() {
+	printf("------------------\n");
+	printf("Test: skl_search\n\n");
+	int n = sizeof(tests) / sizeof(RECORD);
+	SKL sklist = { 0 };
+	for (int i = 0; i < n; i++) {
+		skl_insert(&sklist, tests[i].name, tests[i].score);
+	}
+	printf("given skip list:");
+	skl_display(&sklist);
+	printf("\n");
+	n = sizeof search_items / sizeof *search_items;
+	for (int i = 0; i < n; i++) {
+		SKLNODE *np = skl_search(&sklist, search_items[i]);
+		if (np != NULL)
+			printf("skl_search(%s): %s %.1f\n", search_items[i], np->data.name,
+					np->data.score);
+		else
+			printf("skl_search(%s): not found\n", search_items[i]);
+	}
+	skl_clean(&sklist);
+	printf("\n");
+}
+
+void test_skl_delete() {
+	printf("------------------\n");
+	printf("Test: skl_delete\n\n");
+	int n = sizeof(tests) / sizeof(RECORD);
+	SKL sklist = { 0 };
+	for (int i = 0; i < n - 1; i++) {
+		skl_insert(&sklist, tests[i].name, tests[i].score);
+	}
+	n = sizeof delete_items / sizeof *delete_items;
+	printf("given skip list:");
+	skl_display(&sklist);
+	printf("\n");
+	for (int i = 0; i < n; i++) {
+		int deleted = skl_delete(&sklist, delete_items[i]);
+		printf("skl_delete(%s): %d ", delete_items[i], deleted);
+		skl_display(&sklist);
+		printf("\n");
+	}
+	// deleted nodes are reused by later inserts
+	skl_insert(&sklist, "A4", 45);
+	printf("skl_insert(A4 45.0): ");
+	skl_display(&sklist);
+	printf("\n");
+	skl_clean(&sklist);
+	printf("\n");
+}
+
+void test_skl_prefix() {
+	printf("------------------\n");
+	printf("Test: skl_first_prefix, skl_next_prefix\n\n");
+	int n = sizeof(tests) / sizeof(RECORD);
+	SKL sklist = { 0 };
+	for (int i = 0; i < n; i++) {
+		skl_insert(&sklist, tests[i].name, tests[i].score);
+	}
+	skl_insert(&sklist, "A1", 15);
+	n = sizeof prefix_items / sizeof *prefix_items;
+	for (int i = 0; i < n; i++) {
+		printf("prefix(%s):", prefix_items[i]);
+		for (SKLNODE *np = skl_first_prefix(&sklist, prefix_items[i]); np != NULL;
+				np = skl_next_prefix(np, prefix_items[i])) {
+			printf(" %s %.1f", np->data.name, np->data.score);
+		}
+		printf("\n");
+	}
+	skl_clean(&sklist);
+	printf("\n");
+}
+
+/*
+ * Insert, search, count a prefix range and delete n records with random
+ * names in a skip list and, for small n, in a linked list.
+ */
+void time_test_skl(int n) {
+	char (*names)[20] = malloc(n * sizeof *names);
+	for (int i = 0; i < n; i++) {
+		sprintf(names[i], "N%09d", i);
+	}
+	for (int i = n - 1; i > 0; i--) {
+		int j = rand() % (i + 1);
+		char t[20];
+		memcpy(t, names[i], sizeof t);
+		memcpy(names[i], names[j], sizeof t);
+		memcpy(names[j], t, sizeof t);
+	}
+
+	SKL sklist = { 0 };
+	clock_t t1 = clock();
+	for (int i = 0; i < n; i++) {
+		skl_insert(&sklist, names[i], i);
+	}
+	clock_t t2 = clock();
+	int found = 0;
+	for (int i = 0; i < n; i++) {
+		found += skl_search(&sklist, names[n - 1 - i]) != NULL;
+	}
+	clock_t t3 = clock();
+	int range = 0;
+	for (SKLNODE *np = skl_first_prefix(&sklist, "N0000001"); np != NULL;
+			np = skl_next_prefix(np, "N0000001")) {
+		range++;
+	}
+	for (int i = 0; i < n; i++) {
+		skl_delete(&sklist, names[i]);
+	}
+	clock_t t4 = clock();
+	skl_clean(&sklist);
+	printf("skip list   %9d: insert %0.3f (s), search %0.3f (s), delete %0.3f (s), found %d, prefix range %d\n",
+			n, (double) (t2 - t1) / CLOCKS_PER_SEC, (double) (t3 - t2) / CLOCKS_PER_SEC,
+			(double) (t4 - t3) / CLOCKS_PER_SEC, found, range);
+
+	if (n <= SLL_MAX_BENCH) {
+		SLL sllist = { 0 };
+		t1 = clock();
+		for (int i = 0; i < n; i++) {
+			sll_insert(&sllist, names[i], i);
+		}
+		t2 = clock();
+		found = 0;
+		for (int i = 0; i < n; i++) {
+			found += sll_search(&sllist, names[n - 1 - i]) != NULL;
+		}
+		t3 = clock();
+		for (int i = 0; i < n; i++) {
+			sll_delete(&sllist, names[i]);
+		}
+		t4 = clock();
+		sll_clean(&sllist);
+		printf("linked list %9d: insert %0.3f (s), search %0.3f (s), delete %0.3f (s), found %d\n",
+				n, (double) (t2 - t1) / CLOCKS_PER_SEC, (double) (t3 - t2) / CLOCKS_PER_SEC,
+				(double) (t4 - t3) / CLOCKS_PER_SEC, found);
+	}
+	free(names);
+}
+
+int main(int argc, char* args[]) {
+	if (argc > 1) {
+		int max = atoi(args[1]);
+		printf("------------------\n");
+		printf("Test: runtime, 1000 to %d records\n\n", max);
+		for (int n = 1000; n <= max; n *= 10) {
+			time_test_skl(n);
+		}
+		return 0;
+	}
+	test_skl_insert();
+	test_skl_search();
+	test_skl_delete();
+	test_skl_prefix();
+	return 0;
+}
@@ -0,0 +1,194 @@
+#include "myrecord_ullist.h"
+
+/*
+ * Allocate an empty node.
+ */
+static ULLNODE *ull_node(void) {
+    ULLNODE *np = (ULLNODE *)malloc(sizeof(ULLNODE));
+    if (np == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(EXIT_FAILURE);
+    }
+    np->next = NULL;
+    np->count = 0;
+    return np;
+}
+
+/*
+ * Walk to the first node whose last record name is not less than name, reading
+ * one record per node. If prevp is not NULL, *prevp is set to the node before
+ * it. Returns NULL if all records are less than name.
+ */
+static ULLNODE *ull_find(ULL *ullp, char *name, ULLNODE **prevp) {
+    ULLNODE *prev = NULL, *np = ullp->start;
+    while (np != NULL && strcmp(np->data[np->count - 1].name, name) < 0) {
+        prev = np;
+        np = np->next;
+    }
+    if (prevp != NULL)
+        *prevp = prev;
+    return np;
+}
+
+/*
+ * Index of the first record of the node whose name is not less than name.
+ */
+static int lower_bound(ULLNODE *np, char *name) {
+    int lo = 0, hi = np->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (strcmp(np->data[mid].name, name) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * Searches the unrolled linked list for the first record whose name matches the given key.
+ *
+ * @param ullp - pointer to the unrolled linked list structure.
+ * @param name - the key to search for.
+ * @return Pointer to the found record if present; otherwise NULL.
+ */
+RECORD *ull_search(ULL *ullp, char *name) {
+    if (ullp == NULL || ullp->start == NULL || name == NULL) {
+        return NULL;
+    }
+    ULLNODE *np = ull_find(ullp, name, NULL);
+    if (np == NULL) {
+        return NULL;
+    }
+    int i = lower_bound(np, name);
+    return (strcmp(np->data[i].name, name) == 0) ? &np->data[i] : NULL;
+}
+
+/**
+ * Inserts a new record into the unrolled linked list while keeping the list sorted by the record name.
+ *
+ * @param ullp - pointer to the unrolled linked list structure.
+ * @param name - name field of the new record.
+ * @param score - the score of the new record.
+ */
+void ull_insert(ULL *ullp, char *name, float score) {
+    if (ullp == NULL || name == NULL) {
+        return;
+    }
+
+    // The key is the name as stored, truncated like in sll_insert.
+    RECORD data;
+    strncpy(data.name, name, sizeof(data.name) - 1);
+    data.name[sizeof(data.name) - 1] = '\0';
+    data.score = score;
+
+    ULLNODE *np;
+    int i = 0;
+    if (ullp->start == NULL) {
+        np = ullp->start = ull_node();
+        ullp->nodes = 1;
+    } else {
+        ULLNODE *prev = NULL;
+        np = ull_find(ullp, data.name, &prev);
+        if (np == NULL) {
+            np = prev;   // greater than all records, append to the last node
+            i = np->count;
+        } else {
+            i = lower_bound(np, data.name);
+        }
+    }
+
+    // Split a full node, moving its upper half to a new next node.
+    if (np->count == (int) ULL_CAPACITY) {
+        ULLNODE *new_node = ull_node();
+        int half = np->count / 2;
+        new_node->count = np->count - half;
+        memcpy(new_node->data, np->data + half, new_node->count * sizeof(RECORD));
+        np->count = half;
+        new_node->next = np->next;
+        np->next = new_node;
+        ullp->nodes++;
+        if (i > half) {
+            np = new_node;
+            i -= half;
+        }
+    }
+    memmove(np->data + i + 1, np->data + i, (np->count - i) * sizeof(RECORD));
+    np->data[i] = data;
+    np->count++;
+    ullp->length++;
+}
+
+/**
+ * Deletes the first record from the unrolled linked list whose name matches the given key.
+ *
+ * @param ullp - pointer to the unrolled linked list structure.
+ * @param name - the key used to find the record for deletion.
+ * @return 1 if a record was deleted; 0 otherwise.
+ */
+int ull_delete(ULL *ullp, char *name) {
+    if (ullp == NULL || ullp->start == NULL || name == NULL) {
+        return 0;
+    }
+    ULLNODE *prev = NULL;
+    ULLNODE *np = ull_find(ullp, name, &prev);
+    if (np == NULL) {
+        return 0;
+    }
+    int i = lower_bound(np, name);
+    if (strcmp(np->data[i].name, name) != 0) {
+        return 0;
+    }
+    np->count--;
+    memmove(np->data + i, np->data + i + 1, (np->count - i) * sizeof(RECORD));
+    ullp->length--;
+
+    ULLNODE *next = np->next;
+    if (np->count < (int) ULL_MERGE_BELOW && next != NULL) {
+        if (np->count + next->count <= (int) (ULL_CAPACITY * 3 / 4)) {
+            // Merge the next node into this one.
+            memcpy(np->data + np->count, next->data, next->count * sizeof(RECORD));
+            np->count += next->count;
+            np->next = next->next;
+            free(next);
+            ullp->nodes--;
+        } else {
+            // Take records from the next node so that both are half full.
+            int move = (next->count - np->count) / 2;
+            memcpy(np->data + np->count, next->data, move * sizeof(RECORD));
+            np->count += move;
+            next->count -= move;
+            memmove(next->data, next->data + move, next->count * sizeof(RECORD));
+        }
+    } else if (np->count == 0) {
+        // Only the last node can become empty.
+        if (prev == NULL) {
+            ullp->start = NULL;
+        } else {
+            prev->next = NULL;
+        }
+        free(np);
+        ullp->nodes--;
+    }
+    return 1;
+}
+
+/**
+ * Deletes all nodes in the unrolled linked list and resets its length.
+ *
+ * @param ullp - pointer to the unrolled linked list structure.
+ */
+void ull_clean(ULL *ullp) {
+    if (ullp == NULL) {
+        return;
+    }
+    ULLNODE *current = ullp->start;
+    while (current != NULL) {
+        ULLNODE *temp = current;
+        current = current->next;
+        free(temp);
+    }
+    ullp->start = NULL;
+    ullp->length = 0;
+    ullp->nodes = 0;
+}
@@ -0,0 +1,77 @@
+#ifndef MYRECORD_ULLIST_H
+#define MYRECORD_ULLIST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "myrecord_sllist.h"
+
+#define ULL_NODE_BYTES 4096   // bytes of a node, one page
+#define ULL_CAPACITY ((ULL_NODE_BYTES - 2 * sizeof(void *)) / sizeof(RECORD))
+                              // records per node, 170 with 24-byte records
+#define ULL_MERGE_BELOW (ULL_CAPACITY / 4)  // a node this small takes from its next node
+
+/**
+ * Unrolled list node structure
+ * next   - pointer pointing to the next node of the list
+ * count  - the number of records in data
+ * data   - the records of the node, sorted by name
+ */
+typedef struct ull_node {
+  struct ull_node *next;
+  int count;
+  RECORD data[ULL_CAPACITY];
+} ULLNODE;
+
+/**
+ * Unrolled linked list structure, the records sorted by name as in SLL.
+ * A zero-initialized ULL is an empty list.
+ * length  - the number of records of the list
+ * nodes   - the number of nodes of the list
+ * start   - pointer pointing to the first node of the list
+ */
+typedef struct ullist {
+  int length;
+  int nodes;
+  ULLNODE *start;
+} ULL;
+
+/**
+ * Search unrolled linked list by the key name.
+ *
+ * @param ullp - address of an unrolled linked list structure.
+ * @param name - key to search
+ * @return Pointer to the first record with the name if found; otherwise NULL.
+ *         The pointer is valid until the next insert or delete.
+ */
+RECORD *ull_search(ULL *ullp, char *name);
+
+/**
+ * Insert a new record to unrolled linked list at the position sorted by record
+ * name field, before any records of the same name. A full node is split in two.
+ *
+ * @param ullp - address of an unrolled linked list structure.
+ * @param name - name field of the new record.
+ * @param score - the score data of the new record.
+ */
+void ull_insert(ULL *ullp, char *name, float score);
+
+/**
+ * Delete the first record matched by the name key from unrolled linked list.
+ * A node left with fewer than ULL_MERGE_BELOW records is merged with its next
+ * node, or takes records from it.
+ *
+ * @param ullp - address of an unrolled linked list structure.
+ * @param name - key used to find the record for deletion.
+ * @return 1 if deleted a matched record, 0 otherwise.
+ */
+int ull_delete(ULL *ullp, char *name);
+
+/**
+ * Clean unrolled linked list, delete all nodes.
+ *
+ * @param ullp - address of an unrolled linked list structure.
+ */
+void ull_clean(ULL *ullp);
+
+#endif
@@ -0,0 +1,240 @@
+/*
+ --------------------------------------------------
+ File:    myrecord_ullist_ptest.c
+ About:   public test driver
+ Version: 2025-02-04
+ --------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "myrecord_ullist.h"
+
+#define SLL_MAX_BENCH 30000   // the linked list is only timed up to this size
+
+RECORD tests[] = { { "A1", 10 }, { "A2", 20 }, { "A3", 30 }, { "A4", 40 }, {
+		"A5", 50 }, { "A6", 60 }, { "A7", 70 }, { "A8", 80 }, { "A9", 90 }, {
+		"A10", 100 } };
+char *delete_items[] = { "A2", "A4", "A6", "A8", "B" };
+char *search_items[] = { "A1", "A3", "A5", "B" };
+
+void ull_display(ULL *ullp) {
+	printf("length %d ", ullp->length);
+	for (ULLNODE *np = ullp->start; np != NULL; np = np->next) {
+		for (int i = 0; i < np->count; i++) {
+			printf("%s %.1f ", np->data[i].name, np->data[i].score);
+		}
+	}
+}
+
+void ull_display_nodes(ULL *ullp) {
+	printf("length %d nodes %d:", ullp->length, ullp->nodes);
+	for (ULLNODE *np = ullp->start; np != NULL; np = np->next) {
+		printf(" [%s..%s %d]", np->data[0].name, np->data[np->count - 1].name,
+				np->count);
+	}
+}
+
+void test_ull_insert() {
+	printf("------------------\n");
+	printf("Test: ull_insert\n\n");
+	int n = sizeof(tests) / sizeof(RECORD);
+	ULL ullist = { 0 };
+	printf("given unrolled list:");
+	ull_display(&ullist);
+	printf("\n");
+	for (int i = n - 2; i >= n / 2; i--) {
+		printf("ull_insert(%s %0.1f): ", tests[i].name, tests[i].score);
+		ull_insert(&ullist, tests[i].name, tests[i].score);
+		ull_display(&ullist);
+		printf("\n");
+	}
+	ull_clean(&ullist);
+	printf("\n");
+}
+
+void test_ull_search() {
+	printf("------------------\n");
+	printf("Test: ull_search\n\n");
+	int n = sizeof(tests) / sizeof(RECORD);
+	ULL ullist = { 0 };
+	for (int i = 0; i < n; i++) {
+		ull_insert(&ullist, tests[i].name, tests[i].score);
+	}
+	printf("given unrolled list:");
+	ull_display(&ullist);
+	printf("\n");
+	n = sizeof search_items / sizeof *search_items;
+	for (int i = 0; i < n; i++) {
+		RECORD *rp = ull_search(&ullist, search_items[i]);
+		if (rp != NULL)
+			printf("ull_search(%s): %s %.1f\n", search_items[i], rp->name,
+					rp->score);
+		else
+			printf("ull_search(%s): not found\n", search_items[i]);
+	}
+	ull_clean(&ullist);
+	printf("\n");
+}
+
+void test_ull_delete() {
+	printf("------------------\n");
+	printf("Test: ull_delete\n\n");
+	int n = sizeof(tests) / sizeof(RECORD);
+	ULL ullist = { 0 };
+	for (int i = 0; i < n - 1; i++) {
+		ull_insert(&ullist, tests[i].name, tests[i].score);
+	}
+	n = sizeof delete_items / sizeof *delete_items;
+	printf("given unrolled list:");
+	ull_display(&ullist);
+	printf("\n");
+	for (int i = 0; i < n; i++) {
+		int deleted = ull_delete(&ullist, delete_items[i]);
+		printf("ull_delete(%s): %d ", delete_items[i], deleted);
+		ull_display(&ullist);
+		printf("\n");
+	}
+	ull_clean(&ullist);
+	printf("\n");
+}
+
+void test_ull_split_merge() {
+	printf("------------------\n");
+	printf("Test: ull_insert split, ull_delete merge\n\n");
+	ULL ullist = { 0 };
+	char name[20];
+	for (int i = 0; i < 400; i++) {
+		sprintf(name, "R%03d", (i * 7) % 400);
+		ull_insert(&ullist, name, i);
+	}
+	printf("insert R000..R399: ");
+	ull_display_nodes(&ullist);
+	printf("\n");
+	for (int i = 0; i < 400; i++) {
+		if (i % 8 != 0) {
+			sprintf(name, "R%03d", i);
+			ull_delete(&ullist, name);
+		}
+	}
+	printf("delete all but R000, R008, ..: ");
+	ull_display_nodes(&ullist);
+	printf("\n");
+	int sorted = 1, found = 0;
+	char *last = "";
+	for (ULLNODE *np = ullist.start; np != NULL; np = np->next) {
+		for (int i = 0; i < np->count; i++) {
+			sorted &= strcmp(last, np->data[i].name) <= 0;
+			last = np->data[i].name;
+		}
+	}
+	for (int i = 0; i < 400; i += 8) {
+		sprintf(name, "R%03d", i);
+		found += ull_search(&ullist, name) != NULL;
+	}
+	printf("sorted: %d, search R000, R008, ..: found %d\n", sorted, found);
+	for (int i = 0; i < 400; i += 8) {
+		sprintf(name, "R%03d", i);
+		ull_delete(&ullist, name);
+	}
+	printf("delete all: ");
+	ull_display_nodes(&ullist);
+	printf("\n");
+	ull_clean(&ullist);
+	printf("\n");
+}
+
+/*
+ * Insert, search, scan and delete n records with random names in an unrolled
+ * list and, for small n, in a linked list.
+ */
+void time_test_ull(int n) {
+	char (*names)[20] = malloc(n * sizeof *names);
+	for (int i = 0; i < n; i++) {
+		sprintf(names[i], "N%09d", i);
+	}
+	for (int i = n - 1; i > 0; i--) {
+		int j = rand() % (i + 1);
+		char t[20];
+		memcpy(t, names[i], sizeof t);
+		memcpy(names[i], names[j], sizeof t);
+		memcpy(names[j], t, sizeof t);
+	}
+
+	ULL ullist = { 0 };
+	clock_t t1 = clock();
+	for (int i = 0; i < n; i++) {
+		ull_insert(&ullist, names[i], i);
+	}
+	clock_t t2 = clock();
+	int found = 0;
+	for (int i = 0; i < n; i++) {
+		found += ull_search(&ullist, names[n - 1 - i]) != NULL;
+	}
+	clock_t t3 = clock();
+	double sum = 0;
+	for (ULLNODE *np = ullist.start; np != NULL; np = np->next) {
+		for (int i = 0; i < np->count; i++) {
+			sum += np->data[i].score;
+		}
+	}
+	clock_t t4 = clock();
+	int nodes = ullist.nodes;
+	for (int i = 0; i < n; i++) {
+		ull_delete(&ullist, names[i]);
+	}
+	clock_t t5 = clock();
+	ull_clean(&ullist);
+	printf("unrolled list %8d: insert %0.3f (s), search %0.3f (s), scan %0.4f (s), delete %0.3f (s), found %d, nodes %d\n",
+			n, (double) (t2 - t1) / CLOCKS_PER_SEC, (double) (t3 - t2) / CLOCKS_PER_SEC,
+			(double) (t4 - t3) / CLOCKS_PER_SEC, (double) (t5 - t4) / CLOCKS_PER_SEC,
+			found, nodes);
+
+	if (n <= SLL_MAX_BENCH) {
+		SLL sllist = { 0 };
+		t1 = clock();
+		for (int i = 0; i < n; i++) {
+			sll_insert(&sllist, names[i], i);
+		}
+		t2 = clock();
+		found = 0;
+		for (int i = 0; i < n; i++) {
+			found += sll_search(&sllist, names[n - 1 - i]) != NULL;
+		}
+		t3 = clock();
+		double sll_sum = 0;
+		for (NODE *np = sllist.start; np != NULL; np = np->next) {
+			sll_sum += np->data.score;
+		}
+		t4 = clock();
+		for (int i = 0; i < n; i++) {
+			sll_delete(&sllist, names[i]);
+		}
+		t5 = clock();
+		sll_clean(&sllist);
+		printf("linked list   %8d: insert %0.3f (s), search %0.3f (s), scan %0.4f (s), delete %0.3f (s), found %d, same sum %d\n",
+				n, (double) (t2 - t1) / CLOCKS_PER_SEC, (double) (t3 - t2) / CLOCKS_PER_SEC,
+				(double) (t4 - t3) / CLOCKS_PER_SEC, (double) (t5 - t4) / CLOCKS_PER_SEC,
+				found, sll_sum == sum);
+	}
+	free(names);
+}
+
+int main(int argc, char* args[]) {
+	if (argc > 1) {
+		int max = atoi(args[1]);
+		printf("------------------\n");
+		printf("Test: runtime, 1000 to %d records\n\n", max);
+		for (int n = 1000; n <= max; n *= 10) {
+			time_test_ull(n);
+		}
+		return 0;
+	}
+	test_ull_insert();
+	test_ull_search();
+	test_ull_delete();
+	test_ull_split_merge();
+	return 0;
+}
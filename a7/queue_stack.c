@@ -1,4 +1,6 @@
 #include "queue_stack.h"
+#include <stdint.h>
+#include <string.h>
 
 /*---------- QUEUE IMPLEMENTATION ----------*/
 
@@ -96,3 +98,300 @@ void freeStack(STACK *s) {
 }
 
 
+/*---------- DEQUE IMPLEMENTATION ----------*/
+
+DEQUE *createDeque(void) {
+    DEQUE *d = malloc(sizeof(DEQUE));
+    if (d) {
+        d->items = NULL;
+        d->capacity = d->head = d->count = 0;
+    }
+    return d;
+}
+
+// Double the array, moving the items to its start in order.
+static int growDeque(DEQUE *d) {
+    size_t capacity = d->capacity ? 2 * d->capacity : DEQUE_MIN_CAPACITY;
+    void **items = malloc(capacity * sizeof(void *));
+    if (!items)
+        return 0;
+    size_t first = d->capacity - d->head;  // items before the wrap
+    if (first > d->count)
+        first = d->count;
+    if (d->count) {
+        memcpy(items, d->items + d->head, first * sizeof(void *));
+        memcpy(items + first, d->items, (d->count - first) * sizeof(void *));
+    }
+    free(d->items);
+    d->items = items;
+    d->capacity = capacity;
+    d->head = 0;
+    return 1;
+}
+
+int pushBack(DEQUE *d, void *item) {
+    if (!d || (d->count == d->capacity && !growDeque(d)))
+        return 0;
+    d->items[(d->head + d->count) & (d->capacity - 1)] = item;
+    d->count++;
+    return 1;
+}
+
+int pushFront(DEQUE *d, void *item) {
+    if (!d || (d->count == d->capacity && !growDeque(d)))
+        return 0;
+    d->head = (d->head - 1) & (d->capacity - 1);
+    d->items[d->head] = item;
+    d->count++;
+    return 1;
+}
+
+void *popFront(DEQUE *d) {
+    if (!d || d->count == 0)
+        return NULL;
+    void *item = d->items[d->head];
+    d->head = (d->head + 1) & (d->capacity - 1);
+    d->count--;
+    return item;
+}
+
+void *popBack(DEQUE *d) {
+    if (!d || d->count == 0)
+        return NULL;
+    d->count--;
+    return d->items[(d->head + d->count) & (d->capacity - 1)];
+}
+
+int isEmptyDeque(const DEQUE *d) {
+    return (d == NULL || d->count == 0);
+}
+
+void clearDeque(DEQUE *d) {
+    if (d)
+        d->head = d->count = 0;
+}
+
+void freeDeque(DEQUE *d) {
+    if (!d)
+        return;
+    free(d->items);
+    free(d);
+}
+
+/*---------- CONCURRENT QUEUE IMPLEMENTATION ----------*/
+
+CQUEUE *createConcurrentQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+    CQUEUE *q = aligned_alloc(CACHE_LINE, sizeof(CQUEUE));
+    if (!q)
+        return NULL;
+    q->buffer = malloc(size * sizeof(CQueueCell));
+    if (!q->buffer) {
+        free(q);
+        return NULL;
+    }
+    for (size_t i = 0; i < size; i++)
+        atomic_init(&q->buffer[i].sequence, i);
+    q->mask = size - 1;
+    atomic_init(&q->enqueuePos, 0);
+    atomic_init(&q->dequeuePos, 0);
+    return q;
+}
+
+int concurrentEnqueue(CQUEUE *q, void *item) {
+    if (!q || !item)
+        return 0;
+    size_t pos = atomic_load_explicit(&q->enqueuePos, memory_order_relaxed);
+    CQueueCell *cell;
+    for (;;) {
+        cell = &q->buffer[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            // The cell is free for this position; claim the position.
+            if (atomic_compare_exchange_weak_explicit(&q->enqueuePos, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            return 0;  // the cell still holds the item of the previous lap
+        } else {
+            pos = atomic_load_explicit(&q->enqueuePos, memory_order_relaxed);
+        }
+    }
+    cell->data = item;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    return 1;
+}
+
+void *concurrentDequeue(CQUEUE *q) {
+    if (!q)
+        return NULL;
+    size_t pos = atomic_load_explicit(&q->dequeuePos, memory_order_relaxed);
+    CQueueCell *cell;
+    for (;;) {
+        cell = &q->buffer[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            // The cell is full for this position; claim the position.
+            if (atomic_compare_exchange_weak_explicit(&q->dequeuePos, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            return NULL;  // no item enqueued at this position yet
+        } else {
+            pos = atomic_load_explicit(&q->dequeuePos, memory_order_relaxed);
+        }
+    }
+    void *data = cell->data;
+    // Free the cell for the enqueue of the next lap.
+    atomic_store_explicit(&cell->sequence, pos + q->mask + 1, memory_order_release);
+    return data;
+}
+
+int isEmptyConcurrentQueue(CQUEUE *q) {
+    if (!q)
+        return 1;
+    size_t pos = atomic_load_explicit(&q->dequeuePos, memory_order_relaxed);
+    size_t seq = atomic_load_explicit(&q->buffer[pos & q->mask].sequence, memory_order_acquire);
+    return (intptr_t)seq - (intptr_t)(pos + 1) < 0;
+}
+
+void freeConcurrentQueue(CQUEUE *q) {
+    if (!q)
+        return;
+    free(q->buffer);
+    free(q);
+}
+
+/*---------- CONCURRENT STACK IMPLEMENTATION ----------*/
+
+// The hazard record this thread took last, tried first on its next pop.
+static _Thread_local int hazardHint;
+
+CSTACK *createConcurrentStack(void) {
+    CSTACK *s = aligned_alloc(CACHE_LINE, sizeof(CSTACK));
+    if (!s)
+        return NULL;
+    atomic_init(&s->top, NULL);
+    for (int i = 0; i < CSTACK_MAX_THREADS; i++) {
+        atomic_init(&s->records[i].hazard, NULL);
+        atomic_init(&s->records[i].active, 0);
+        s->records[i].retired = NULL;
+        s->records[i].retiredCount = 0;
+    }
+    return s;
+}
+
+int concurrentPush(CSTACK *s, void *item) {
+    if (!s)
+        return 0;
+    CStackNode *newNode = malloc(sizeof(CStackNode));
+    if (!newNode)
+        return 0;
+    newNode->data = item;
+    CStackNode *top = atomic_load_explicit(&s->top, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&newNode->next, top, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&s->top, &top, newNode,
+            memory_order_release, memory_order_relaxed));
+    return 1;
+}
+
+// Take a free hazard record, spinning while all are in use.
+static HazardRecord *acquireHazard(CSTACK *s) {
+    for (int i = hazardHint;; i = (i + 1) % CSTACK_MAX_THREADS) {
+        HazardRecord *rec = &s->records[i];
+        int expected = 0;
+        if (!atomic_load_explicit(&rec->active, memory_order_relaxed)
+                && atomic_compare_exchange_strong_explicit(&rec->active, &expected, 1,
+                        memory_order_acquire, memory_order_relaxed)) {
+            hazardHint = i;
+            return rec;
+        }
+    }
+}
+
+// Free the retired nodes of the record that no hazard pointer holds.
+static void scanRetired(CSTACK *s, HazardRecord *rec) {
+    CStackNode *hazards[CSTACK_MAX_THREADS];
+    int n = 0;
+    for (int i = 0; i < CSTACK_MAX_THREADS; i++) {
+        CStackNode *hp = atomic_load(&s->records[i].hazard);
+        if (hp)
+            hazards[n++] = hp;
+    }
+    CStackNode *node = rec->retired, *keep = NULL;
+    rec->retiredCount = 0;
+    while (node) {
+        CStackNode *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        int held = 0;
+        for (int i = 0; i < n && !held; i++)
+            held = (hazards[i] == node);
+        if (held) {
+            atomic_store_explicit(&node->next, keep, memory_order_relaxed);
+            keep = node;
+            rec->retiredCount++;
+        } else {
+            free(node);
+        }
+        node = next;
+    }
+    rec->retired = keep;
+}
+
+void *concurrentPop(CSTACK *s) {
+    if (!s)
+        return NULL;
+    HazardRecord *rec = acquireHazard(s);
+    CStackNode *top;
+    for (;;) {
+        top = atomic_load(&s->top);
+        if (!top)
+            break;
+        // Publish the hazard, then check that top was not popped meanwhile.
+        atomic_store(&rec->hazard, top);
+        if (atomic_load(&s->top) != top)
+            continue;
+        CStackNode *next = atomic_load_explicit(&top->next, memory_order_relaxed);
+        if (atomic_compare_exchange_weak(&s->top, &top, next))
+            break;
+    }
+    atomic_store_explicit(&rec->hazard, NULL, memory_order_release);
+    void *data = NULL;
+    if (top) {
+        data = top->data;
+        atomic_store_explicit(&top->next, rec->retired, memory_order_relaxed);
+        rec->retired = top;
+        if (++rec->retiredCount >= CSTACK_RETIRE_THRESHOLD)
+            scanRetired(s, rec);
+    }
+    atomic_store_explicit(&rec->active, 0, memory_order_release);
+    return data;
+}
+
+int isEmptyConcurrentStack(CSTACK *s) {
+    return (s == NULL || atomic_load_explicit(&s->top, memory_order_relaxed) == NULL);
+}
+
+void freeConcurrentStack(CSTACK *s) {
+    if (!s)
+        return;
+    CStackNode *node = atomic_load_explicit(&s->top, memory_order_relaxed);
+    while (node) {
+        CStackNode *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        free(node);
+        node = next;
+    }
+    for (int i = 0; i < CSTACK_MAX_THREADS; i++) {
+        node = s->records[i].retired;
+        while (node) {
+            CStackNode *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+            free(node);
+            node = next;
+        }
+    }
+    free(s);
+}
@@ -2,6 +2,9 @@
 #define QUEUE_STACK_H
 
 #include <stdlib.h>
+#include <stdatomic.h>
+
+#define CACHE_LINE 64
 
 /*---------- QUEUE ----------*/
 
@@ -61,4 +64,124 @@ int isEmptyStack(const STACK *s);
 /* Free all memory associated with the stack. */
 void freeStack(STACK *s);
 
+/*---------- DEQUE ----------*/
+
+/* A double-ended queue on a circular array that doubles when full. It
+ * serves as a queue (pushBack, popFront) or a stack (pushBack, popBack)
+ * without an allocation per item, and clearDeque keeps the array for
+ * reuse. */
+
+#define DEQUE_MIN_CAPACITY 16
+
+typedef struct deque {
+    void **items;
+    size_t capacity;  // 0 or a power of two
+    size_t head;      // index of the front item
+    size_t count;
+} DEQUE;
+
+/* Create and return a new empty deque. Returns NULL if out of memory. */
+DEQUE *createDeque(void);
+
+/* Add an item at the back. Returns 1 if added, 0 if out of memory. */
+int pushBack(DEQUE *d, void *item);
+
+/* Add an item at the front. Returns 1 if added, 0 if out of memory. */
+int pushFront(DEQUE *d, void *item);
+
+/* Remove the front item. Returns the item pointer, or NULL if empty. */
+void *popFront(DEQUE *d);
+
+/* Remove the back item. Returns the item pointer, or NULL if empty. */
+void *popBack(DEQUE *d);
+
+/* Check if the deque is empty. Returns non-zero if empty, zero otherwise. */
+int isEmptyDeque(const DEQUE *d);
+
+/* Remove all items, keeping the array for later pushes. */
+void clearDeque(DEQUE *d);
+
+/* Free all memory associated with the deque. */
+void freeDeque(DEQUE *d);
+
+/*---------- CONCURRENT QUEUE ----------*/
+
+/* A bounded multi-producer multi-consumer queue on a ring of cells
+ * (Vyukov). Each cell has a sequence number that tells whether it is
+ * free for the enqueue or full for the dequeue at a given position, so
+ * an operation is one CAS on its position counter. */
+
+typedef struct cqueue_cell {
+    atomic_size_t sequence;
+    void *data;
+} CQueueCell;
+
+typedef struct cqueue {
+    _Alignas(CACHE_LINE) CQueueCell *buffer;
+    size_t mask;
+    _Alignas(CACHE_LINE) atomic_size_t enqueuePos;
+    _Alignas(CACHE_LINE) atomic_size_t dequeuePos;
+} CQUEUE;
+
+/* Create and return a new empty concurrent queue of at least capacity
+ * items, rounded up to a power of two. Returns NULL if out of memory. */
+CQUEUE *createConcurrentQueue(size_t capacity);
+
+/* Enqueue a non-NULL item to the queue from any thread.
+ * Returns 1 if enqueued, 0 if the queue is full. */
+int concurrentEnqueue(CQUEUE *q, void *item);
+
+/* Dequeue an item from the queue from any thread.
+ * Returns the item pointer, or NULL if empty. */
+void *concurrentDequeue(CQUEUE *q);
+
+/* Check if the queue is empty at the time of the call. */
+int isEmptyConcurrentQueue(CQUEUE *q);
+
+/* Free all memory associated with the queue. No thread may use it. */
+void freeConcurrentQueue(CQUEUE *q);
+
+/*---------- CONCURRENT STACK ----------*/
+
+/* A lock-free Treiber stack. Popped nodes are reclaimed with hazard
+ * pointers: a popping thread publishes the top node it reads in a hazard
+ * record, and a retired node is freed only when no record holds it. */
+
+#define CSTACK_MAX_THREADS 64  // hazard records, popping threads at a time
+#define CSTACK_RETIRE_THRESHOLD (2 * CSTACK_MAX_THREADS)  // retired nodes before a scan
+
+typedef struct cstack_node {
+    void *data;
+    _Atomic(struct cstack_node *) next;
+} CStackNode;
+
+typedef struct hazard_record {
+    _Alignas(CACHE_LINE) _Atomic(CStackNode *) hazard;
+    atomic_int active;
+    CStackNode *retired;
+    int retiredCount;
+} HazardRecord;
+
+typedef struct cstack {
+    _Alignas(CACHE_LINE) _Atomic(CStackNode *) top;
+    HazardRecord records[CSTACK_MAX_THREADS];
+} CSTACK;
+
+/* Create and return a new empty concurrent stack. Returns NULL if out of memory. */
+CSTACK *createConcurrentStack(void);
+
+/* Push an item onto the stack from any thread.
+ * Returns 1 if pushed, 0 if out of memory. */
+int concurrentPush(CSTACK *s, void *item);
+
+/* Pop an item from the stack from any thread.
+ * Returns the item pointer, or NULL if empty. */
+void *concurrentPop(CSTACK *s);
+
+/* Check if the stack is empty at the time of the call. */
+int isEmptyConcurrentStack(CSTACK *s);
+
+/* Free all memory associated with the stack. No thread may use it. */
+void freeConcurrentStack(CSTACK *s);
+
 #endif // QUEUE_STACK_H
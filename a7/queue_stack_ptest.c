@@ -0,0 +1,285 @@
+/*
+ -------------------------------------------------------
+ File:     queue_stack_ptest.c
+ About:    public test driver
+ Version:  2025-02-28
+ -------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "queue_stack.h"
+
+#define ITEM(i) ((void *)(uintptr_t)((i) + 1))   // a non-NULL item for integer i
+#define INDEX(p) ((long)(uintptr_t)(p) - 1)
+
+void test_queue_stack() {
+	printf("------------------\n");
+	printf("Test: enqueue, dequeue, push, pop\n\n");
+	QUEUE *q = createQueue();
+	STACK *s = createStack();
+	for (int i = 0; i < 5; i++) {
+		enqueue(q, ITEM(i));
+		push(s, ITEM(i));
+	}
+	printf("dequeue:");
+	while (!isEmptyQueue(q))
+		printf(" %ld", INDEX(dequeue(q)));
+	printf("\npop:");
+	while (!isEmptyStack(s))
+		printf(" %ld", INDEX(pop(s)));
+	printf("\n");
+	freeQueue(q);
+	freeStack(s);
+	printf("\n");
+}
+
+void test_deque() {
+	printf("------------------\n");
+	printf("Test: pushBack, pushFront, popFront, popBack\n\n");
+	DEQUE *d = createDeque();
+	for (int i = 0; i < 10; i++)
+		pushBack(d, ITEM(i));
+	for (int i = 10; i < 20; i++)
+		pushFront(d, ITEM(i));
+	printf("capacity: %zu, count: %zu\n", d->capacity, d->count);
+	printf("popFront:");
+	for (int i = 0; i < 5; i++)
+		printf(" %ld", INDEX(popFront(d)));
+	printf("\npopBack:");
+	while (!isEmptyDeque(d))
+		printf(" %ld", INDEX(popBack(d)));
+	printf("\nempty pop: %s\n", popFront(d) == NULL && popBack(d) == NULL ? "NULL" : "item");
+	clearDeque(d);
+	pushBack(d, ITEM(1));
+	printf("after clearDeque, capacity: %zu, popFront: %ld\n", d->capacity, INDEX(popFront(d)));
+	freeDeque(d);
+	printf("\n");
+}
+
+void test_concurrent_queue() {
+	printf("------------------\n");
+	printf("Test: concurrentEnqueue, concurrentDequeue\n\n");
+	CQUEUE *q = createConcurrentQueue(5);
+	printf("capacity: %zu\n", q->mask + 1);
+	printf("concurrentEnqueue:");
+	for (int i = 0; i < 10; i++)
+		printf(" %d", concurrentEnqueue(q, ITEM(i)));
+	printf("\nconcurrentDequeue:");
+	for (int i = 0; i < 3; i++)
+		printf(" %ld", INDEX(concurrentDequeue(q)));
+	for (int i = 10; i < 13; i++)
+		concurrentEnqueue(q, ITEM(i));
+	while (!isEmptyConcurrentQueue(q))
+		printf(" %ld", INDEX(concurrentDequeue(q)));
+	printf("\nempty dequeue: %s\n", concurrentDequeue(q) == NULL ? "NULL" : "item");
+	freeConcurrentQueue(q);
+	printf("\n");
+}
+
+void test_concurrent_stack() {
+	printf("------------------\n");
+	printf("Test: concurrentPush, concurrentPop\n\n");
+	CSTACK *s = createConcurrentStack();
+	for (int i = 0; i < 5; i++)
+		concurrentPush(s, ITEM(i));
+	printf("concurrentPop:");
+	for (int i = 0; i < 2; i++)
+		printf(" %ld", INDEX(concurrentPop(s)));
+	concurrentPush(s, ITEM(5));
+	while (!isEmptyConcurrentStack(s))
+		printf(" %ld", INDEX(concurrentPop(s)));
+	printf("\nempty pop: %s\n", concurrentPop(s) == NULL ? "NULL" : "item");
+	// leave nodes in the stack and in the retired lists for freeConcurrentStack
+	for (int i = 0; i < 3 * CSTACK_RETIRE_THRESHOLD; i++)
+		concurrentPush(s, ITEM(i));
+	for (int i = 0; i < 2 * CSTACK_RETIRE_THRESHOLD + 1; i++)
+		concurrentPop(s);
+	freeConcurrentStack(s);
+	printf("\n");
+}
+
+/*
+ * Producers and consumers moving items through one container. Producer p
+ * sends the items p, p + producers, p + 2 * producers, ... below total;
+ * consumers add up what they receive and, for the queue, check that the
+ * items of each producer arrive in order.
+ */
+typedef struct worker {
+	int kind;                 // 0 concurrent queue, 1 concurrent stack, 2 and 3 locked QUEUE and STACK
+	int id;
+	int producers;
+	long total;
+	void *container;
+	pthread_mutex_t *lock;
+	atomic_long *consumed;
+	long sum;
+	long *last;               // consumers: last item seen from each producer
+	int ordered;
+} WORKER;
+
+static int put(WORKER *w, void *item) {
+	switch (w->kind) {
+	case 0:
+		return concurrentEnqueue(w->container, item);
+	case 1:
+		return concurrentPush(w->container, item);
+	default:
+		pthread_mutex_lock(w->lock);
+		if (w->kind == 2)
+			enqueue(w->container, item);
+		else
+			push(w->container, item);
+		pthread_mutex_unlock(w->lock);
+		return 1;
+	}
+}
+
+static void *take(WORKER *w) {
+	void *item;
+	switch (w->kind) {
+	case 0:
+		return concurrentDequeue(w->container);
+	case 1:
+		return concurrentPop(w->container);
+	default:
+		pthread_mutex_lock(w->lock);
+		item = (w->kind == 2) ? dequeue(w->container) : pop(w->container);
+		pthread_mutex_unlock(w->lock);
+		return item;
+	}
+}
+
+void *produce(void *arg) {
+	WORKER *w = arg;
+	for (long i = w->id; i < w->total; i += w->producers) {
+		while (!put(w, ITEM(i)))
+			sched_yield();
+	}
+	return NULL;
+}
+
+void *consume(void *arg) {
+	WORKER *w = arg;
+	while (atomic_load(w->consumed) < w->total) {
+		void *item = take(w);
+		if (item == NULL) {
+			sched_yield();
+			continue;
+		}
+		atomic_fetch_add(w->consumed, 1);
+		long i = INDEX(item);
+		w->sum += i;
+		int p = i % w->producers;
+		if (i < w->last[p])
+			w->ordered = 0;
+		w->last[p] = i;
+	}
+	return NULL;
+}
+
+/*
+ * Run producers and consumers over a container of the given kind and
+ * return the elapsed wall time, or -1 if an item was lost.
+ */
+double run_workers(int kind, int producers, int consumers, long total, int *ordered) {
+	QUEUE *q = NULL;
+	STACK *s = NULL;
+	void *container;
+	if (kind == 0)
+		container = createConcurrentQueue(1024);
+	else if (kind == 1)
+		container = createConcurrentStack();
+	else if (kind == 2)
+		container = q = createQueue();
+	else
+		container = s = createStack();
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	atomic_long consumed = 0;
+	int n = producers + consumers;
+	WORKER *w = calloc(n, sizeof(WORKER));
+	pthread_t *tids = malloc(n * sizeof(pthread_t));
+	struct timespec t1, t2;
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	for (int i = 0; i < n; i++) {
+		w[i] = (WORKER) { kind, i, producers, total, container, &lock, &consumed, 0, NULL, 1 };
+		if (i >= producers) {
+			w[i].last = malloc(producers * sizeof(long));
+			for (int p = 0; p < producers; p++)
+				w[i].last[p] = -1;
+		}
+		pthread_create(&tids[i], NULL, i < producers ? produce : consume, &w[i]);
+	}
+	long sum = 0;
+	*ordered = 1;
+	for (int i = 0; i < n; i++) {
+		pthread_join(tids[i], NULL);
+		if (i >= producers) {
+			sum += w[i].sum;
+			*ordered &= w[i].ordered;
+			free(w[i].last);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+	if (kind == 0)
+		freeConcurrentQueue(container);
+	else if (kind == 1)
+		freeConcurrentStack(container);
+	else if (kind == 2)
+		freeQueue(q);
+	else
+		freeStack(s);
+	free(w);
+	free(tids);
+	if (sum != total * (total - 1) / 2)
+		return -1;
+	return (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9;
+}
+
+void test_concurrent_threads() {
+	printf("------------------\n");
+	printf("Test: concurrent queue and stack, 4 producers, 4 consumers\n\n");
+	int ordered;
+	double t = run_workers(0, 4, 4, 100000, &ordered);
+	printf("concurrent queue: %s, per producer order: %s\n", t < 0 ? "lost items" : "all items",
+			ordered ? "kept" : "broken");
+	t = run_workers(1, 4, 4, 100000, &ordered);
+	printf("concurrent stack: %s\n", t < 0 ? "lost items" : "all items");
+	printf("\n");
+}
+
+/*
+ * Move total items through each container with 1 to max producers and
+ * as many consumers.
+ */
+void time_test_contention(int max, long total) {
+	char *names[] = { "concurrent queue", "concurrent stack", "locked QUEUE", "locked STACK" };
+	printf("------------------\n");
+	printf("Test: runtime, %ld items, 1 to %d producers and consumers\n\n", total, max);
+	for (int threads = 1; threads <= max; threads *= 2) {
+		for (int kind = 0; kind < 4; kind++) {
+			int ordered;
+			double t = run_workers(kind, threads, threads, total, &ordered);
+			printf("%-16s %2d producers %2d consumers: %0.3f (s), %0.2f M items/s\n",
+					names[kind], threads, threads, t, t > 0 ? total / t / 1e6 : 0);
+		}
+	}
+	printf("\n");
+}
+
+int main(int argc, char* args[]) {
+	if (argc > 1) {
+		time_test_contention(atoi(args[1]), argc > 2 ? atol(args[2]) : 2000000);
+		return 0;
+	}
+	test_queue_stack();
+	test_deque();
+	test_concurrent_queue();
+	test_concurrent_stack();
+	test_concurrent_threads();
+	return 0;
+}
@@ -1,5 +1,7 @@
 #include "tree.h"
 #include "queue_stack.h"  
+#include <pthread.h>
+#include <stdatomic.h>
 
 /*----------------------------------------------------
   TREE PROPERTIES AND RECURSIVE TRAVERSALS
@@ -50,45 +52,109 @@ void postorder(TNODE *root) {
   ITERATIVE BREADTH-FIRST TRAVERSAL AND SEARCH
 ----------------------------------------------------*/
 
+// Each thread keeps the deque of its iterative traversals under a thread
+// key, so its grown array is reused by the next traversal and freed when
+// the thread exits. A deque grown beyond traversal_limit items is freed
+// after the traversal instead, unless the limit is 0.
+static pthread_key_t traversal_key;
+static pthread_once_t traversal_once = PTHREAD_ONCE_INIT;
+static int traversal_key_ok = 0;
+static atomic_size_t traversal_limit = 0;
+
+static void free_traversal(void *d) {
+    freeDeque((DEQUE *)d);
+}
+
+static void make_traversal_key(void) {
+    traversal_key_ok = (pthread_key_create(&traversal_key, free_traversal) == 0);
+}
+
+// traversal_deque: Get the empty traversal deque of this thread, creating it
+// on first use.
+static DEQUE *traversal_deque(void) {
+    pthread_once(&traversal_once, make_traversal_key);
+    DEQUE *d = traversal_key_ok ? pthread_getspecific(traversal_key) : NULL;
+    if (d == NULL) {
+        d = createDeque();
+        if (d != NULL && traversal_key_ok)
+            pthread_setspecific(traversal_key, d);
+    }
+    clearDeque(d);
+    return d;
+}
+
+// release_traversal: End a traversal, freeing its deque if it is not kept
+// for the next one.
+static void release_traversal(DEQUE *d) {
+    if (!traversal_key_ok) {
+        freeDeque(d);
+    } else {
+        size_t limit = atomic_load_explicit(&traversal_limit, memory_order_relaxed);
+        if (limit == 0 || d->capacity <= limit)
+            return;
+        freeDeque(d);
+        pthread_setspecific(traversal_key, NULL);
+    }
+}
+
+// traversal_keep_limit: Set the largest deque kept between traversals.
+void traversal_keep_limit(size_t items) {
+    atomic_store_explicit(&traversal_limit, items, memory_order_relaxed);
+}
+
+// clean_traversal: Free the traversal deque of this thread.
+void clean_traversal(void) {
+    pthread_once(&traversal_once, make_traversal_key);
+    if (traversal_key_ok) {
+        freeDeque(pthread_getspecific(traversal_key));
+        pthread_setspecific(traversal_key, NULL);
+    }
+}
+
 // bforder: Print tree nodes in breadth-first order using a queue.
 void bforder(TNODE *root) {
     if (root == NULL)
         return;
     
-    QUEUE *q = createQueue();
-    enqueue(q, (void *)root);
+    DEQUE *q = traversal_deque();
+    if (q == NULL)
+        return;
+    pushBack(q, (void *)root);
     
-    while (!isEmptyQueue(q)) {
-        TNODE *node = (TNODE *)dequeue(q);
+    while (!isEmptyDeque(q)) {
+        TNODE *node = (TNODE *)popFront(q);
         printf("%c ", node->data);
         if (node->left != NULL)
-            enqueue(q, (void *)node->left);
+            pushBack(q, (void *)node->left);
         if (node->right != NULL)
-            enqueue(q, (void *)node->right);
+            pushBack(q, (void *)node->right);
     }
-    freeQueue(q);
+    release_traversal(q);
 }
 // bfs: Search for a node with key using breadth-first search.
 TNODE *bfs(TNODE *root, char key) {
     if (root == NULL)
         return NULL;
     
-    QUEUE *q = createQueue();
-    enqueue(q, (void *)root);
+    DEQUE *q = traversal_deque();
+    if (q == NULL)
+        return NULL;
+    pushBack(q, (void *)root);
     
-    while (!isEmptyQueue(q)) {
-        TNODE *node = (TNODE *)dequeue(q);
+    TNODE *found = NULL;
+    while (!isEmptyDeque(q)) {
+        TNODE *node = (TNODE *)popFront(q);
         if (node->data == key) {
-            freeQueue(q);
-            return node;
+            found = node;
+            break;
         }
         if (node->left != NULL)
-            enqueue(q, (void *)node->left);
+            pushBack(q, (void *)node->left);
         if (node->right != NULL)
-            enqueue(q, (void *)node->right);
+            pushBack(q, (void *)node->right);
     }
-    freeQueue(q);
-    return NULL;
+    release_traversal(q);
+    return found;
 }
 
 /*----------------------------------------------------
@@ -100,23 +166,26 @@ TNODE *dfs(TNODE *root, char key) {
     if (root == NULL)
         return NULL;
     
-    STACK *s = createStack();
-    push(s, (void *)root);
+    DEQUE *s = traversal_deque();
+    if (s == NULL)
+        return NULL;
+    pushBack(s, (void *)root);
     
-    while (!isEmptyStack(s)) {
-        TNODE *node = (TNODE *)pop(s);
+    TNODE *found = NULL;
+    while (!isEmptyDeque(s)) {
+        TNODE *node = (TNODE *)popBack(s);
         if (node->data == key) {
-            freeStack(s);
-            return node;
+            found = node;
+            break;
         }
         // Push right child first so that left child is processed first.
         if (node->right != NULL)
-            push(s, (void *)node->right);
+            pushBack(s, (void *)node->right);
         if (node->left != NULL)
-            push(s, (void *)node->left);
+            pushBack(s, (void *)node->left);
     }
-    freeStack(s);
-    return NULL;
+    release_traversal(s);
+    return found;
 }
 
 /*----------------------------------------------------
@@ -146,7 +215,7 @@ void clean_tree(TNODE **rootp) {
 }
 
 // insert_tree: Insert a new node with the given value at the first available position
-// (level order, left to right) using a queue.
+// (level order, left to right) using the traversal deque as a queue.
 void insert_tree(TNODE **rootp, char val) {
     TNODE *new_node = tree_node(val);
     if (*rootp == NULL) {
@@ -154,25 +223,77 @@ void insert_tree(TNODE **rootp, char val) {
         return;
     }
     
-    QUEUE *q = createQueue();
-    enqueue(q, (void *)*rootp);
+    DEQUE *q = traversal_deque();
+    if (q == NULL) {
+        free(new_node);
+        return;
+    }
+    pushBack(q, (void *)*rootp);
     
-    while (!isEmptyQueue(q)) {
-        TNODE *node = (TNODE *)dequeue(q);
+    while (!isEmptyDeque(q)) {
+        TNODE *node = (TNODE *)popFront(q);
         if (node->left == NULL) {
             node->left = new_node;
-            freeQueue(q);
-            return;
+            break;
         } else {
-            enqueue(q, (void *)node->left);
+            pushBack(q, (void *)node->left);
         }
         if (node->right == NULL) {
             node->right = new_node;
-            freeQueue(q);
-            return;
+            break;
         } else {
-            enqueue(q, (void *)node->right);
+            pushBack(q, (void *)node->right);
         }
     }
-    freeQueue(q);
+    release_traversal(q);
+}
+
+// insert_tree_n: Insert a new node with the given value into a complete tree of
+// n nodes. Numbering the nodes from 1 in level order, the new node is number
+// n + 1, and the bits of n + 1 after the leading one give the path to it from
+// the root: 0 for left, 1 for right.
+void insert_tree_n(TNODE **rootp, int n, char val) {
+    TNODE *new_node = tree_node(val);
+    if (new_node == NULL)
+        return;
+    if (*rootp == NULL || n <= 0) {
+        *rootp = new_node;
+        return;
+    }
+    unsigned pos = (unsigned)n + 1;
+    int bit = 31 - __builtin_clz(pos) - 1;  // the bit below the leading one
+    TNODE *node = *rootp;
+    for (; bit > 0; bit--)
+        node = (pos >> bit) & 1 ? node->right : node->left;
+    if (pos & 1)
+        node->right = new_node;
+    else
+        node->left = new_node;
+}
+
+// build_tree_from_array: Build a complete tree of the n values of a in level
+// order. Node i gets the children 2i + 1 and 2i + 2.
+TNODE *build_tree_from_array(char *a, int n) {
+    if (a == NULL || n <= 0)
+        return NULL;
+    TNODE **nodes = (TNODE **)malloc(n * sizeof(TNODE *));
+    if (nodes == NULL)
+        return NULL;
+    for (int i = 0; i < n; i++) {
+        nodes[i] = tree_node(a[i]);
+        if (nodes[i] == NULL) {
+            while (i > 0)
+                free(nodes[--i]);
+            free(nodes);
+            return NULL;
+        }
+    }
+    for (int i = 0; 2 * i + 1 < n; i++) {
+        nodes[i]->left = nodes[2 * i + 1];
+        if (2 * i + 2 < n)
+            nodes[i]->right = nodes[2 * i + 2];
+    }
+    TNODE *root = nodes[0];
+    free(nodes);
+    return root;
 }
@@ -93,4 +93,38 @@ void clean_tree(TNODE **rootp);
  */
 void insert_tree(TNODE **rootp, char val);
 
+/* Create a new node with the given value and insert it into a complete tree
+ * of n nodes at the first available position in breadth-first order, the
+ * same position as insert_tree(), following the bits of n + 1 from the root
+ * in O(log n) time.
+ *
+ * @param rootp - pointer to pointer to the root of a complete tree
+ * @param n     - the number of nodes of the tree
+ * @param val   - data for the new node
+ */
+void insert_tree_n(TNODE **rootp, int n, char val);
+
+/* Build a complete tree of n nodes holding a[0..n-1] in breadth-first order
+ * in O(n) time, the tree that n calls of insert_tree() would build.
+ *
+ * @param a - array of node data
+ * @param n - the number of nodes
+ * @return - pointer to the root of the tree, NULL if n <= 0 or out of memory
+ */
+TNODE *build_tree_from_array(char *a, int n);
+
+/* Free the deque that bforder, bfs, dfs and insert_tree keep between calls
+ * in the calling thread. The next traversal creates it again. The deque of
+ * a thread is also freed when the thread exits.
+ */
+void clean_traversal(void);
+
+/* Limit the deque kept between traversals: a traversal that grows the deque
+ * of its thread beyond items entries frees it when done. The default 0
+ * keeps the deque at any size until clean_traversal() or thread exit.
+ *
+ * @param items - the largest deque capacity kept, 0 for no limit
+ */
+void traversal_keep_limit(size_t items);
+
 #endif // TREE_H
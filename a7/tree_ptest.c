@@ -8,7 +8,46 @@
  */
 
 #include <stdio.h>
+#include <time.h>
 #include "tree.h"
+#include "queue_stack.h"
+
+#define INSERT_TREE_MAX_BENCH 20000   // insert_tree is only timed up to this size
+
+/*
+ * Counting allocator for the runtime tests: the malloc family of the whole
+ * program counts its calls and forwards them to the C library. Not used
+ * under AddressSanitizer, which has its own allocator.
+ */
+long allocator_calls = 0;
+
+#if !defined(__SANITIZE_ADDRESS__) && defined(__GLIBC__)
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void __libc_free(void *p);
+
+void *malloc(size_t size) {
+	allocator_calls++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+	allocator_calls++;
+	return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size) {
+	allocator_calls++;
+	return __libc_realloc(p, size);
+}
+
+void free(void *p) {
+	if (p != NULL)
+		allocator_calls++;
+	__libc_free(p);
+}
+#endif
 
 void search_info(char *sf, char key, TNODE *tnp);
 void display_tree(TNODE *root, int pretype, int prelen);
@@ -36,6 +75,7 @@ void test_end() {
 	printf("------------------\n");
 	printf("Test end: clean testing tree\n\n");
 	clean_tree(&root);
+	clean_traversal();
 	printf("\n");
 }
 
@@ -112,10 +152,149 @@ void test_dfs() {
 	printf("\n");
 }
 
+void test_build_tree() {
+	printf("------------------\n");
+	printf("Test: insert_tree_n, build_tree_from_array\n\n");
+	int n = sizeof tree_tests / sizeof *tree_tests;
+	TNODE *tree = NULL;
+	for (int i = 0; i < n; i++) {
+		insert_tree_n(&tree, i, tree_tests[i]);
+	}
+	printf("insert_tree_n: ");
+	bforder(tree);
+	printf("\n");
+	display_tree(tree, 0, 0);
+	clean_tree(&tree);
+	for (int m = 0; m <= n; m = 2 * m + 1) {
+		tree = build_tree_from_array(tree_tests, m);
+		printf("build_tree_from_array(%d): ", m);
+		bforder(tree);
+		printf("\n");
+		clean_tree(&tree);
+	}
+	printf("\n");
+}
+
 void search_info(char *sf, char key, TNODE *tnp);
 void display_tree(TNODE *root, int pretype, int prelen);
 
-int main() {
+/*
+ * Node data of a tree of n nodes, filled with letters.
+ */
+char *tree_data(int n) {
+	char *a = malloc(n);
+	for (int i = 0; i < n; i++)
+		a[i] = 'a' + i % 26;
+	return a;
+}
+
+/*
+ * bfs with a linked QUEUE, one malloc per enqueue and one free per dequeue,
+ * as bfs was before it used the traversal deque.
+ */
+TNODE *bfs_queue(TNODE *root, char key) {
+	QUEUE *q = createQueue();
+	enqueue(q, (void *)root);
+	TNODE *found = NULL;
+	while (!isEmptyQueue(q)) {
+		TNODE *node = (TNODE *)dequeue(q);
+		if (node->data == key) {
+			found = node;
+			break;
+		}
+		if (node->left != NULL)
+			enqueue(q, (void *)node->left);
+		if (node->right != NULL)
+			enqueue(q, (void *)node->right);
+	}
+	freeQueue(q);
+	return found;
+}
+
+/*
+ * Time runs searches for a missing key with f over tree, and count the
+ * allocator calls of the first run and of the later runs.
+ */
+void time_search(char *name, TNODE *(*f)(TNODE *, char), TNODE *tree, int runs) {
+	clock_t t1 = clock();
+	long calls = allocator_calls;
+	f(tree, '#');
+	long first = allocator_calls - calls;
+	for (int r = 1; r < runs; r++)
+		f(tree, '#');
+	long later = allocator_calls - calls - first;
+	clock_t t2 = clock();
+	printf("%-16s %0.3f (s), allocator calls: first %ld, later %ld\n", name,
+			(double) (t2 - t1) / CLOCKS_PER_SEC, first, later);
+}
+
+/*
+ * Search a missing key over a complete tree of n nodes, repeated runs
+ * times, with the linked QUEUE and with the library traversals.
+ */
+void time_test_traversal(int n, int runs) {
+	printf("------------------\n");
+	printf("Test: runtime, %d nodes, %d searches\n\n", n, runs);
+	char *a = tree_data(n);
+	TNODE *tree = build_tree_from_array(a, n);
+	free(a);
+	clean_traversal();
+	time_search("bfs, QUEUE:", bfs_queue, tree, runs);
+	time_search("bfs:", bfs, tree, runs);
+	time_search("dfs:", dfs, tree, runs);
+	clean_traversal();
+	traversal_keep_limit(4096);
+	time_search("bfs, limit 4096:", bfs, tree, runs);
+	traversal_keep_limit(0);
+	clean_tree(&tree);
+	clean_traversal();
+	printf("\n");
+}
+
+/*
+ * Build a tree of n nodes with insert_tree_n and build_tree_from_array,
+ * and of up to INSERT_TREE_MAX_BENCH nodes with insert_tree.
+ */
+void time_test_build(int n) {
+	printf("------------------\n");
+	printf("Test: runtime, build a tree of %d nodes\n\n", n);
+	char *a = tree_data(n);
+	TNODE *tree = NULL;
+	int m = n < INSERT_TREE_MAX_BENCH ? n : INSERT_TREE_MAX_BENCH;
+	clock_t t1 = clock();
+	for (int i = 0; i < m; i++)
+		insert_tree(&tree, a[i]);
+	clock_t t2 = clock();
+	printf("insert_tree, %d nodes:   %0.3f (s)\n", m, (double) (t2 - t1) / CLOCKS_PER_SEC);
+	clean_tree(&tree);
+
+	t1 = clock();
+	for (int i = 0; i < n; i++)
+		insert_tree_n(&tree, i, a[i]);
+	t2 = clock();
+	TPROPS props = tree_property(tree);
+	printf("insert_tree_n:          %0.3f (s), order %d, height %d\n",
+			(double) (t2 - t1) / CLOCKS_PER_SEC, props.order, props.height);
+	clean_tree(&tree);
+
+	t1 = clock();
+	tree = build_tree_from_array(a, n);
+	t2 = clock();
+	props = tree_property(tree);
+	printf("build_tree_from_array:  %0.3f (s), order %d, height %d\n",
+			(double) (t2 - t1) / CLOCKS_PER_SEC, props.order, props.height);
+	clean_tree(&tree);
+	clean_traversal();
+	free(a);
+	printf("\n");
+}
+
+int main(int argc, char* args[]) {
+	if (argc > 1) {
+		time_test_build(atoi(args[1]));
+		time_test_traversal(atoi(args[1]), argc > 2 ? atoi(args[2]) : 10);
+		return 0;
+	}
 	test_before();
 	test_tree_property();
 	test_preorder();
@@ -124,6 +303,7 @@ int main() {
 	test_bforder();
 	test_bfs();
 	test_dfs();
+	test_build_tree();
 	test_end();
 
 	return 0;